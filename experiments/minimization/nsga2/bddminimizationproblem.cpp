@@ -7,6 +7,7 @@ BDDMinimizationProblem::BDDMinimizationProblem(const Cudd& mgr, const std::vecto
                                                float max_error_rate, bool er_and_ace, float max_ace)
     : mgr(&mgr)
     , original(&original)
+    , prepared_original(std::make_shared<abo::error_metrics::PreparedOriginal>(mgr, original))
     , max_error_rate(max_error_rate)
     , max_average_case_error(max_ace)
     , original_node_count(mgr.nodeCount(original))
@@ -75,8 +76,6 @@ BDDMinimizationProblem::function_from_individuum(const pagmo::vector_double& par
 
 pagmo::vector_double BDDMinimizationProblem::fitness(const pagmo::vector_double& parameters) const
 {
-    const std::vector<BDD>& function = *original;
-
     std::vector<BDD> individuum_function = function_from_individuum(parameters);
 
     // compute error metrics
@@ -98,13 +97,13 @@ pagmo::vector_double BDDMinimizationProblem::fitness(const pagmo::vector_double&
         }
     }
 
-    double error_rate = abo::error_metrics::error_rate(*mgr, function, individuum_function);
+    abo::error_metrics::MetricContext context(prepared_original, individuum_function);
+    double error_rate = abo::error_metrics::error_rate(context);
 
     double average_case_error = 0;
     if (er_and_ace)
     {
-        average_case_error =
-            double(abo::error_metrics::average_case_error(*mgr, function, individuum_function));
+        average_case_error = double(abo::error_metrics::average_case_error(context));
     }
 
     // punish error values above the maximum error metrics (the exact multipliers do not matter
@@ -1,6 +1,7 @@
 #ifndef BDDMINIMIZATIONPROBLEM_H
 #define BDDMINIMIZATIONPROBLEM_H
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -10,6 +11,8 @@
 
 #include <cudd/cplusplus/cuddObj.hh>
 
+#include "metric_context.hpp"
+
 /**
  * @brief The BDDMinimizationProblem class
  * It creates and handles individuals that represent approximated functions for the use in a genetic
@@ -70,6 +73,8 @@ private:
     // these must be pointers due to the necessary default constructability
     const Cudd* mgr = nullptr;
     const std::vector<BDD>* original = nullptr;
+    //! the structures of the error metrics that only depend on the original function
+    std::shared_ptr<abo::error_metrics::PreparedOriginal> prepared_original;
 
     const float max_error_rate = 0.05f;
     const float max_average_case_error = 1;
@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+#include <cudd/cplusplus/cuddObj.hh>
+
+#include "accumulator.hpp"
+#include "approximate_adders.hpp"
+#include "benchmark_util.hpp"
+#include "compiled_forest.hpp"
+#include "cudd_helpers.hpp"
+
+using namespace abo::benchmark;
+
+// the sum of the minterm counts of all bits weighted with their significance, as in average_value
+template <typename Integer>
+static Integer weighted_minterm_sum(const abo::util::CompiledForest& forest)
+{
+    const std::vector<Integer> counts = forest.minterm_counts<Integer>();
+    Integer sum = 0;
+    for (unsigned int i = 0; i < counts.size(); i++)
+    {
+        sum += Integer(counts[i] << i);
+    }
+    return sum;
+}
+
+// input: accumulator type (64 bit, 128 bit, cpp_int), adder generator, parameters for that
+// generator
+static void accumulator_types(benchmark::State& state)
+{
+    const int accumulator = static_cast<int>(state.range(0));
+    const ApproximateAdder adder = static_cast<ApproximateAdder>(state.range(1));
+    const std::string accumulator_names[] = {"uint64_t", "__int128", "cpp_int"};
+
+    state.SetLabel(approximate_adder_name(adder, state.range(2), state.range(3), state.range(4)) +
+                   " - " + accumulator_names[accumulator]);
+
+    Cudd mgr(state.range(2) + 1);
+    auto correct = abo::example_bdds::regular_adder(mgr, state.range(2));
+    std::vector<BDD> approximate_adder =
+        get_approximate_adder(mgr, adder, state.range(2), state.range(3), state.range(4));
+    std::vector<BDD> difference = abo::util::bdd_absolute_difference(
+        mgr, correct, approximate_adder, abo::util::NumberRepresentation::BaseTwo);
+    const abo::util::CompiledForest forest(difference);
+
+    const std::size_t bits = difference.size() + forest.num_levels() + 1;
+    if ((accumulator == 0 && bits > 64) || (accumulator == 1 && bits > 128))
+    {
+        state.SkipWithError("the accumulator is too narrow for this adder");
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        switch (accumulator)
+        {
+            case 0:
+                benchmark::DoNotOptimize(weighted_minterm_sum<std::uint64_t>(forest));
+                break;
+            case 1:
+                benchmark::DoNotOptimize(weighted_minterm_sum<abo::util::UInt128>(forest));
+                break;
+            default:
+                benchmark::DoNotOptimize(
+                    weighted_minterm_sum<boost::multiprecision::cpp_int>(forest));
+        }
+    }
+}
+
+BENCHMARK(accumulator_types)->Unit(benchmark::kMicrosecond)->Apply([](auto* b) {
+    for (int accumulator : {0, 1, 2})
+    {
+        b = b->Args({accumulator, static_cast<int>(ApproximateAdder::ACA1), 8, 5, 0})
+                ->Args({accumulator, static_cast<int>(ApproximateAdder::GDA), 8, 4, 2})
+                ->Args({accumulator, static_cast<int>(ApproximateAdder::GEAR), 8, 2, 2})
+                ->Args({accumulator, static_cast<int>(ApproximateAdder::ACA1), 16, 4, 0})
+                ->Args({accumulator, static_cast<int>(ApproximateAdder::ACA2), 16, 8, 0})
+                ->Args({accumulator, static_cast<int>(ApproximateAdder::GEAR), 16, 4, 4})
+                ->Args({accumulator, static_cast<int>(ApproximateAdder::ACA1), 32, 8, 0})
+                ->Args({accumulator, static_cast<int>(ApproximateAdder::ACA1), 32, 16, 0});
+    }
+});
+
+BENCHMARK_MAIN();
@@ -1,6 +1,7 @@
 #include <benchmark/benchmark.h>
 #include <cudd/cplusplus/cuddObj.hh>
 
+#include "allocation_counter.hpp"
 #include "approximate_adders.hpp"
 #include "benchmark_util.hpp"
 
@@ -25,9 +26,15 @@ static void generate_adders(benchmark::State& state)
         auto correct = abo::example_bdds::regular_adder(mgr, state.range(2));
         std::vector<BDD> approximate_adder =
             get_approximate_adder(mgr, adder, state.range(2), state.range(3), state.range(4));
+        abo::util::AllocationCounter counter(mgr);
         state.ResumeTiming();
 
         abo::benchmark::compute_error_metric(mgr, correct, approximate_adder, metric);
+
+        state.PauseTiming();
+        state.counters["allocated_nodes"] = counter.allocated_nodes();
+        state.counters["garbage_collections"] = counter.garbage_collections();
+        state.ResumeTiming();
     }
 }
 
@@ -0,0 +1,120 @@
+#include <benchmark/benchmark.h>
+#include <cudd/cplusplus/cuddObj.hh>
+#include <map>
+
+#include "../util/benchmark_util.hpp"
+#include "cudd_helpers.hpp"
+
+using namespace abo::benchmark;
+
+enum AnnotationMethod
+{
+    MAP,
+    NODE_ANNOTATION
+};
+
+// the recursive std::map based minterm count that was used before the node annotation tables
+static double count_minterms_map_rec(DdNode* node, std::map<DdNode*, double>& minterm_count)
+{
+    const auto it = minterm_count.find(node);
+    if (it != minterm_count.end())
+    {
+        return it->second;
+    }
+
+    double result;
+    if (Cudd_IsConstant(node))
+    {
+        result = Cudd_IsComplement(node) ? 0.0 : 1.0;
+    }
+    else
+    {
+        DdNode* then_child = Cudd_NotCond(Cudd_T(node), Cudd_IsComplement(node));
+        DdNode* else_child = Cudd_NotCond(Cudd_E(node), Cudd_IsComplement(node));
+        result = count_minterms_map_rec(then_child, minterm_count) / 2 +
+                 count_minterms_map_rec(else_child, minterm_count) / 2;
+    }
+    minterm_count[node] = result;
+    return result;
+}
+
+static double annotate(const std::vector<BDD>& function, AnnotationMethod method)
+{
+    double sum = 0;
+    for (const BDD& bit : function)
+    {
+        switch (method)
+        {
+        case MAP:
+        {
+            std::map<DdNode*, double> minterm_count;
+            sum += count_minterms_map_rec(bit.getNode(), minterm_count);
+            break;
+        }
+        case NODE_ANNOTATION:
+            sum += abo::util::count_minterms(bit).at(bit.getNode());
+            break;
+        }
+    }
+    return sum;
+}
+
+static std::string method_name(int method)
+{
+    return method == MAP ? "std::map" : "node annotation";
+}
+
+// input: annotation method, iscas 85 test file
+static void benchmark_annotation_iscas_85(benchmark::State& state)
+{
+    const AnnotationMethod method = static_cast<AnnotationMethod>(state.range(0));
+    const ISCAS85File file_id = static_cast<ISCAS85File>(state.range(1));
+    state.SetLabel(iscas_85_filename_by_id(file_id) + " - " + method_name(method));
+
+    Cudd mgr(0);
+    std::vector<BDD> function = load_iscas_85_file(mgr, file_id);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(annotate(function, method));
+    }
+}
+
+// input: annotation method, epfl test file
+static void benchmark_annotation_epfl(benchmark::State& state)
+{
+    const AnnotationMethod method = static_cast<AnnotationMethod>(state.range(0));
+    const EPFLFile file_id = static_cast<EPFLFile>(state.range(1));
+    state.SetLabel(epfl_filename_by_id(file_id) + " - " + method_name(method));
+
+    Cudd mgr(0);
+    std::vector<BDD> function = load_epfl_benchmark_file(mgr, file_id);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(annotate(function, method));
+    }
+}
+
+BENCHMARK(benchmark_annotation_iscas_85)->Unit(benchmark::kMillisecond)->Apply([](auto* b) {
+    for (auto file : {ISCAS85File::C432, ISCAS85File::C499, ISCAS85File::C880, ISCAS85File::C1908,
+                      ISCAS85File::C2670, ISCAS85File::C3540, ISCAS85File::C5315})
+    {
+        for (auto method : {MAP, NODE_ANNOTATION})
+        {
+            b = b->Args({method, static_cast<int>(file)});
+        }
+    }
+});
+
+BENCHMARK(benchmark_annotation_epfl)->Unit(benchmark::kMillisecond)->Apply([](auto* b) {
+    for (auto file : {EPFLFile::Adder, EPFLFile::Bar, EPFLFile::Max, EPFLFile::Sin})
+    {
+        for (auto method : {MAP, NODE_ANNOTATION})
+        {
+            b = b->Args({method, static_cast<int>(file)});
+        }
+    }
+});
+
+BENCHMARK_MAIN();
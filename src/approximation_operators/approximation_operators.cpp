@@ -1,32 +1,34 @@
 #include "approximation_operators.hpp"
 #include "cudd_helpers.hpp"
 
-#include <map>
 #include <stdexcept>
 
 #include <cudd/cudd/cudd.h>
 #include <cudd_helpers.hpp>
+#include <node_annotation.hpp>
+
+using abo::util::NodeAnnotation;
 
 namespace abo::operators {
 
 static DdNode* remove_children_rec(DdManager* dd, DdNode* node,
                                    unsigned int level_start,
                                    unsigned int level_end,
-                                   const std::map<DdNode*, double>& minterm_count,
-                                   std::map<DdNode*, DdNode*>& round_map,
+                                   const NodeAnnotation<double>& minterm_count,
+                                   NodeAnnotation<DdNode*>& round_map,
                                    bool remove_heavy,
                                    bool subset);
 
 static DdNode* round_rec(DdManager* dd, DdNode* node,
                          unsigned int level_start,
-                         const std::map<DdNode*, double>& minterm_count,
-                         std::map<DdNode*, DdNode*>& round_map);
+                         const NodeAnnotation<double>& minterm_count,
+                         NodeAnnotation<DdNode*>& round_map);
 
 static DdNode* round_best_rec(DdManager* dd, DdNode* node,
                               unsigned int level_start,
                               unsigned int level_end,
-                              const std::map<DdNode*, double>& minterm_count,
-                              std::map<DdNode*, DdNode*>& round_map);
+                              const NodeAnnotation<double>& minterm_count,
+                              NodeAnnotation<DdNode*>& round_map);
 
 static BDD round_any(const Cudd& mgr, const BDD& bdd,
                      const unsigned int level_start,
@@ -63,7 +65,7 @@ BDD subset_heavy_child(const Cudd& mgr, const BDD& bdd,
 
 BDD round_bdd(const Cudd& mgr, const BDD& bdd, const unsigned int level)
 {
-    std::map<DdNode*, DdNode*> round_map;
+    NodeAnnotation<DdNode*> round_map;
     DdNode* node = round_rec(mgr.getManager(), bdd.getNode(), level,
                              abo::util::count_minterms(bdd), round_map);
     return BDD(mgr, node);
@@ -72,7 +74,7 @@ BDD round_bdd(const Cudd& mgr, const BDD& bdd, const unsigned int level)
 BDD round_best(const Cudd& mgr, const BDD& bdd,
                unsigned int level_start, unsigned int level_end)
 {
-    std::map<DdNode*, DdNode*> round_map;
+    NodeAnnotation<DdNode*> round_map;
     DdNode* node = round_best_rec(mgr.getManager(), bdd.getNode(),
                                   level_start, level_end,
                                   abo::util::count_minterms(bdd),
@@ -83,7 +85,7 @@ BDD round_best(const Cudd& mgr, const BDD& bdd,
 BDD round_up(const Cudd& mgr, const BDD& bdd,
              unsigned int level_start, unsigned int level_end)
 {
-    std::map<DdNode*, DdNode*> round_map;
+    NodeAnnotation<DdNode*> round_map;
     DdNode* node = remove_children_rec(mgr.getManager(), bdd.getNode(),
                                        level_start, level_end,
                                        abo::util::count_solutions(bdd),
@@ -94,7 +96,7 @@ BDD round_up(const Cudd& mgr, const BDD& bdd,
 BDD round_down(const Cudd& mgr, const BDD& bdd,
                unsigned int level_start, unsigned int level_end)
 {
-    std::map<DdNode*, DdNode*> round_map;
+    NodeAnnotation<DdNode*> round_map;
     DdNode* node = remove_children_rec(mgr.getManager(), bdd.getNode(),
                                        level_start, level_end,
                                        abo::util::count_solutions(bdd),
@@ -105,8 +107,8 @@ BDD round_down(const Cudd& mgr, const BDD& bdd,
 static DdNode* remove_children_rec(DdManager* const dd, DdNode* const node,
                                    const unsigned int level_start,
                                    const unsigned int level_end,
-                                   const std::map<DdNode*, double>& minterm_count,
-                                   std::map<DdNode*, DdNode*>& round_map,
+                                   const NodeAnnotation<double>& minterm_count,
+                                   NodeAnnotation<DdNode*>& round_map,
                                    const bool remove_heavy,
                                    const bool subset)
 {
@@ -116,10 +118,10 @@ static DdNode* remove_children_rec(DdManager* const dd, DdNode* const node,
         return node;
     }
 
-    const auto it = round_map.find(node);
-    if (it != round_map.end())
+    DdNode* const* const rounded = round_map.find(node);
+    if (rounded != nullptr)
     {
-        return it->second;
+        return *rounded;
     }
 
     DdNode* const N = Cudd_Regular(node);
@@ -146,17 +148,15 @@ static DdNode* remove_children_rec(DdManager* const dd, DdNode* const node,
     }
     else if (varId >= level_start && varId <= level_end)
     {
-        auto then_minterm_count = minterm_count.find(Nv);
-        auto else_minterm_count = minterm_count.find(Nnv);
+        const double* const then_minterm_count = minterm_count.find(Nv);
+        const double* const else_minterm_count = minterm_count.find(Nnv);
 
-        bool then_found = then_minterm_count != minterm_count.end();
-        bool else_found = else_minterm_count != minterm_count.end();
-        if (!then_found || !else_found)
+        if (then_minterm_count == nullptr || else_minterm_count == nullptr)
         {
             throw std::logic_error("remove_children_rec: node should be in map");
         }
 
-        bool then_is_heavy = then_minterm_count->second > else_minterm_count->second;
+        bool then_is_heavy = *then_minterm_count > *else_minterm_count;
 
         if (remove_heavy == then_is_heavy)
         {
@@ -199,8 +199,8 @@ static DdNode* remove_children_rec(DdManager* const dd, DdNode* const node,
 
 static DdNode* round_rec(DdManager* const dd, DdNode* const node,
                          const unsigned int level_start,
-                         const std::map<DdNode*, double>& minterm_count,
-                         std::map<DdNode*, DdNode*>& round_map)
+                         const NodeAnnotation<double>& minterm_count,
+                         NodeAnnotation<DdNode*>& round_map)
 {
 
     if (Cudd_IsConstant(node))
@@ -208,10 +208,10 @@ static DdNode* round_rec(DdManager* const dd, DdNode* const node,
         return node;
     }
 
-    const auto it = round_map.find(node);
-    if (it != round_map.end())
+    DdNode* const* const rounded = round_map.find(node);
+    if (rounded != nullptr)
     {
-        return it->second;
+        return *rounded;
     }
 
     DdNode* const N = Cudd_Regular(node);
@@ -254,8 +254,8 @@ static DdNode* round_rec(DdManager* const dd, DdNode* const node,
     }
     else
     {
-        auto count = minterm_count.find(node);
-        DdNode* replace = count->second > 0.5 ? Cudd_ReadOne(dd) : Cudd_Not(Cudd_ReadOne(dd));
+        DdNode* replace =
+            minterm_count.at(node) > 0.5 ? Cudd_ReadOne(dd) : Cudd_Not(Cudd_ReadOne(dd));
         round_map[node] = replace;
         return replace;
     }
@@ -264,8 +264,8 @@ static DdNode* round_rec(DdManager* const dd, DdNode* const node,
 static DdNode* round_best_rec(DdManager* const dd, DdNode* const node,
                               const unsigned int level_start,
                               const unsigned int level_end,
-                              const std::map<DdNode*, double>& minterm_count,
-                              std::map<DdNode*, DdNode*>& round_map)
+                              const NodeAnnotation<double>& minterm_count,
+                              NodeAnnotation<DdNode*>& round_map)
 {
 
     if (Cudd_IsConstant(node))
@@ -273,10 +273,10 @@ static DdNode* round_best_rec(DdManager* const dd, DdNode* const node,
         return node;
     }
 
-    const auto it = round_map.find(node);
-    if (it != round_map.end())
+    DdNode* const* const rounded = round_map.find(node);
+    if (rounded != nullptr)
     {
-        return it->second;
+        return *rounded;
     }
 
     DdNode* const N = Cudd_Regular(node);
@@ -303,38 +303,40 @@ static DdNode* round_best_rec(DdManager* const dd, DdNode* const node,
     // reached range of variable levels  to perform the rounding on
     else if (varId >= level_start && varId <= level_end)
     {
-        const auto then_minterm_count = minterm_count.find(Nv);
-        const auto else_minterm_count = minterm_count.find(Nnv);
-        if (then_minterm_count == minterm_count.end() || else_minterm_count == minterm_count.end())
+        const double* const then_count = minterm_count.find(Nv);
+        const double* const else_count = minterm_count.find(Nnv);
+        if (then_count == nullptr || else_count == nullptr)
         {
             throw std::logic_error("round_best_rec: node should be in map");
         }
+        const double then_minterm_count = *then_count;
+        const double else_minterm_count = *else_count;
 
         // TODO Fälle erläutern
 
-        if (then_minterm_count->second < else_minterm_count->second &&
-            then_minterm_count->second < 1 - else_minterm_count->second)
+        if (then_minterm_count < else_minterm_count &&
+            then_minterm_count < 1 - else_minterm_count)
         {
             then_branch = Cudd_Not(Cudd_ReadOne(dd));
             else_branch = round_best_rec(dd, Nnv, level_start, level_end,
                                          minterm_count, round_map);
         }
-        else if (else_minterm_count->second < then_minterm_count->second &&
-                 else_minterm_count->second < 1 - then_minterm_count->second)
+        else if (else_minterm_count < then_minterm_count &&
+                 else_minterm_count < 1 - then_minterm_count)
         {
             then_branch = round_best_rec(dd, Nv, level_start, level_end,
                                          minterm_count, round_map);
             else_branch = Cudd_Not(Cudd_ReadOne(dd));
         }
-        else if (then_minterm_count->second > else_minterm_count->second &&
-                 then_minterm_count->second > 1 - else_minterm_count->second)
+        else if (then_minterm_count > else_minterm_count &&
+                 then_minterm_count > 1 - else_minterm_count)
         {
             then_branch = Cudd_ReadOne(dd);
             else_branch = round_best_rec(dd, Nnv, level_start, level_end,
                                          minterm_count, round_map);
         }
-        else if (else_minterm_count->second > then_minterm_count->second &&
-                 else_minterm_count->second > 1 - then_minterm_count->second)
+        else if (else_minterm_count > then_minterm_count &&
+                 else_minterm_count > 1 - then_minterm_count)
         {
             then_branch = round_best_rec(dd, Nv, level_start, level_end,
                                          minterm_count, round_map);
@@ -343,9 +345,9 @@ static DdNode* round_best_rec(DdManager* const dd, DdNode* const node,
         else
         {
             then_branch =
-                then_minterm_count->second > 0.5 ? Cudd_ReadOne(dd) : Cudd_Not(Cudd_ReadOne(dd));
+                then_minterm_count > 0.5 ? Cudd_ReadOne(dd) : Cudd_Not(Cudd_ReadOne(dd));
             else_branch =
-                else_minterm_count->second > 0.5 ? Cudd_ReadOne(dd) : Cudd_Not(Cudd_ReadOne(dd));
+                else_minterm_count > 0.5 ? Cudd_ReadOne(dd) : Cudd_Not(Cudd_ReadOne(dd));
         }
     }
     else
@@ -377,7 +379,7 @@ static BDD round_any(const Cudd& mgr, const BDD& bdd,
                      const unsigned int level_end,
                      bool remove_heavy, bool subset)
 {
-    std::map<DdNode*, DdNode*> round_map;
+    NodeAnnotation<DdNode*> round_map;
 
     auto mt_count = abo::util::count_minterms(bdd);
     DdNode* node =
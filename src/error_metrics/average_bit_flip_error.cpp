@@ -1,53 +1,87 @@
 #include "average_bit_flip_error.hpp"
+#include "accumulator.hpp"
+#include "compiled_forest.hpp"
 #include "cudd_helpers.hpp"
+#include "incremental_metrics.hpp"
 #include <cassert>
 #include <cmath>
 #include <iostream>
 
+using boost::multiprecision::cpp_int;
+using boost::multiprecision::cpp_rational;
+
 namespace abo::error_metrics {
 
+//! Returns the average number of set bits of the miter, counted exactly in one pass over the forest
+static double average_set_bits(const std::vector<BDD>& miter)
+{
+    const abo::util::CompiledForest forest(miter);
+
+    // the sum is at most miter.size() * 2^levels
+    std::size_t bits = forest.num_levels() + 1;
+    for (std::size_t n = miter.size(); n > 0; n >>= 1)
+    {
+        bits++;
+    }
+    const cpp_int sum = abo::util::with_accumulator(bits, [&forest](auto zero) {
+        using Integer = decltype(zero);
+        Integer sum = 0;
+        for (const Integer& count : forest.minterm_counts<Integer>())
+        {
+            sum += count;
+        }
+        return abo::util::to_cpp_int(sum);
+    });
+    return static_cast<double>(cpp_rational(sum, cpp_int(1) << forest.num_levels()));
+}
+
 double average_bit_flip_error(const std::vector<BDD>& f,
                               const std::vector<BDD>& f_hat)
 {
     assert(f.size() == f_hat.size());
 
-    int max_support_size = 0;
-    for (const auto& bdd : f)
-    {
-        max_support_size = std::max(max_support_size, bdd.SupportSize());
-    }
-    for (const auto& bdd : f_hat)
+    std::vector<BDD> miter;
+    miter.reserve(f.size());
+    for (unsigned int i = 0; i < f.size(); i++)
     {
-        max_support_size = std::max(max_support_size, bdd.SupportSize());
+        miter.push_back(f[i] ^ f_hat[i]);
     }
 
-    double result = 0;
-    for (unsigned int i = 0; i < f.size(); i++)
+    return average_set_bits(miter);
+}
+
+double average_bit_flip_error(MetricContext& context)
+{
+    if (IncrementalMetrics* base = context.single_output_base())
     {
-        result += (f[i] ^ f_hat[i]).CountMinterm(max_support_size);
+        const std::size_t output = context.changed_output();
+        return base->average_bit_flip_error(output, context.approximation()[output]);
     }
-
-    // use double exponentiation to allow for more than 64 input variables
-    return result / std::pow(2.0, max_support_size);
+    return average_set_bits(context.miter());
 }
 
 double average_bit_flip_error_add(const Cudd& mgr,
                                   const std::vector<BDD>& f,
                                   const std::vector<BDD>& f_hat)
 {
-    ADD diff = abo::util::xor_difference_add(mgr, f, f_hat);
-    std::vector<std::pair<double, unsigned long>> terminal_values =
-        abo::util::add_terminal_values(diff);
-    unsigned long bit_count_sum = 0;
-    unsigned long total_path_count = 0;
-    for (auto [value, path_count] : terminal_values)
+    MetricContext context(mgr, f, f_hat);
+    return average_bit_flip_error_add(context);
+}
+
+double average_bit_flip_error_add(MetricContext& context)
+{
+    std::vector<std::pair<double, cpp_int>> terminal_values =
+        abo::util::add_terminal_values(context.xor_difference_add());
+    cpp_int bit_count_sum = 0;
+    cpp_int total_path_count = 0;
+    for (const auto& [value, path_count] : terminal_values)
     {
         // counts the number of set bits in value
         int bitcount = __builtin_popcountll(value);
-        bit_count_sum += static_cast<unsigned long>(bitcount) * path_count;
+        bit_count_sum += bitcount * path_count;
         total_path_count += path_count;
     }
-    return bit_count_sum / static_cast<double>(total_path_count);
+    return static_cast<double>(cpp_rational(bit_count_sum, total_path_count));
 }
 
 } // namespace abo::error_metrics
@@ -3,6 +3,8 @@
 #include <cudd/cplusplus/cuddObj.hh>
 #include <vector>
 
+#include "metric_context.hpp"
+
 namespace abo::error_metrics {
 
 /**
@@ -16,6 +18,9 @@ namespace abo::error_metrics {
 double average_bit_flip_error(const std::vector<BDD>& f,
                               const std::vector<BDD>& f_hat);
 
+//! Computes the average bit flip error of the functions of the context, reusing its miter
+double average_bit_flip_error(MetricContext& context);
+
 /**
  * @brief Compute the average bit flip error between the functions f and f_hat
  * It is computed symbolically using ADDs.
@@ -29,4 +34,7 @@ double average_bit_flip_error_add(const Cudd& mgr,
                                   const std::vector<BDD>& f,
                                   const std::vector<BDD>& f_hat);
 
+//! Computes average_bit_flip_error_add for the functions of the context, reusing its XOR ADD
+double average_bit_flip_error_add(MetricContext& context);
+
 } // namespace abo::error_metrics
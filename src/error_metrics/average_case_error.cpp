@@ -1,65 +1,220 @@
 #include "average_case_error.hpp"
 
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <tuple>
+
 #include <boost/multiprecision/cpp_int.hpp>
 #include <cudd_helpers.hpp>
 
+#include "accumulator.hpp"
+#include "compiled_forest.hpp"
+#include "exact_add.hpp"
+#include "tuple_traversal.hpp"
+
 using abo::util::NumberRepresentation;
 using boost::multiprecision::cpp_dec_float_100;
-using boost::multiprecision::uint256_t;
+using boost::multiprecision::cpp_int;
 
 namespace abo::error_metrics {
 
 cpp_dec_float_100 average_value(const std::vector<BDD>& f)
 {
+    const abo::util::CompiledForest forest(f);
 
-    uint256_t sum = 0;
-    const uint256_t one = 1;
+    // every count is at most 2^levels, so the weighted sum is below 2^(width + levels)
+    auto weighted_sum = [&forest](auto zero) {
+        using Integer = decltype(zero);
+        const std::vector<Integer> counts = forest.minterm_counts<Integer>();
+        Integer sum = 0;
+        for (unsigned int i = 0; i < counts.size(); i++)
+        {
+            sum += Integer(counts[i] << i);
+        }
+        return abo::util::to_cpp_int(sum);
+    };
+    const cpp_int sum =
+        abo::util::with_accumulator(f.size() + forest.num_levels() + 1, weighted_sum);
 
-    int max_support_size = 0;
-    for (const auto& bdd : f)
+    return cpp_dec_float_100(sum) /
+           cpp_dec_float_100(cpp_int(1) << forest.num_levels());
+}
+
+//! Returns the significance of every bit, the sign bit of Two's Complement counts negative
+static std::vector<cpp_int> bit_weights(std::size_t width, const NumberRepresentation num_rep)
+{
+    std::vector<cpp_int> weights;
+    for (std::size_t i = 0; i < width; i++)
     {
-        max_support_size = std::max(max_support_size, bdd.SupportSize());
+        weights.push_back(cpp_int(1) << i);
     }
-
-    for (unsigned int i = 0; i < f.size(); i++)
+    if (num_rep == NumberRepresentation::TwosComplement && width > 0)
     {
-        // TODO: CountMinterms returns a double, might loose precision
-        double minterms = f[i].CountMinterm(max_support_size);
-        sum += (one << i) * uint256_t(minterms);
+        weights.back() = -weights.back();
     }
+    return weights;
+}
 
-    return cpp_dec_float_100(sum) /
-           cpp_dec_float_100(one << max_support_size);
+/**
+ * @brief Sums the squared value of f over all inputs exactly, from the conjunctions of all pairs of
+ * bits
+ *
+ * The square of sum_i w_i f_i is sum_i sum_j w_i w_j (f_i & f_j). This is the fallback of
+ * moment_sums, it needs a quadratic number of conjunctions but each of them is polynomial in the
+ * sizes of its two bits. The conjunctions with one bit are counted together in one
+ * CompiledForest, so only one row of them is alive at a time.
+ *
+ * @param f The function
+ * @param weights The significance of every bit, see bit_weights
+ * @return The sum of the squared values over all num_levels() variables of the manager
+ */
+static cpp_int pairwise_square_sum(const std::vector<BDD>& f, const std::vector<cpp_int>& weights)
+{
+    cpp_int sum = 0;
+    for (std::size_t i = 0; i < f.size(); i++)
+    {
+        std::vector<BDD> conjunctions;
+        for (std::size_t j = i; j < f.size(); j++)
+        {
+            // cudd handles the case i = j efficiently
+            conjunctions.push_back(f[i] & f[j]);
+        }
+        const std::vector<cpp_int> counts =
+            abo::util::CompiledForest(conjunctions).output_minterm_counts();
+        for (std::size_t j = i; j < f.size(); j++)
+        {
+            // all terms except for i == j appear twice when factoring the square
+            const cpp_int term = weights[i] * weights[j] * counts[j - i];
+            sum += i == j ? term : cpp_int(2 * term);
+        }
+    }
+    return sum;
 }
 
-cpp_dec_float_100 mean_squared_value(const std::vector<BDD>& f)
+//! The sums of a value and of its square over all assignments of the variables from the given
+//! level on
+template <typename Integer>
+struct LevelMoments
+{
+    unsigned int level;
+    Integer sum;
+    Integer square_sum;
+};
+
+//! The number of joint cofactors per node of the forest up to which moment_sums traverses them
+static constexpr std::size_t moment_states_per_node = 8;
+
+/**
+ * @brief Sums the value and the squared value of f over all inputs in one bottom-up traversal
+ *
+ * Every joint cofactor of the bits carries the exact sums of the value and of its square over the
+ * assignments of the variables below it, and the sums of a cofactor are those of its children.
+ * The cost is proportional to the number of distinct joint cofactors, which is close to the size
+ * of the forest for most error functions. As it can be exponential, e.g. for the bits of a sum,
+ * the traversal gives up after moment_states_per_node cofactors per node of the forest.
+ *
+ * @tparam Integer The accumulator, see accumulator.hpp. Must be cpp_int if is_signed is set
+ * @param forest The compiled function
+ * @param is_signed Whether the last bit is the sign bit of a Two's Complement number
+ * @return {sum, square sum} over all num_levels() variables, or nothing if the limit is reached
+ */
+template <typename Integer>
+static std::optional<std::pair<cpp_int, cpp_int>>
+moment_sums(const abo::util::CompiledForest& forest, bool is_signed)
 {
+    std::vector<std::size_t> outputs(forest.num_outputs());
+    std::iota(outputs.begin(), outputs.end(), 0);
 
-    uint256_t sum = 0;
-    const uint256_t one = 1;
+    const unsigned int terminal_level = static_cast<unsigned int>(forest.num_levels());
+    const auto root = abo::util::reduce_output_tuples(
+        forest, outputs, moment_states_per_node * forest.num_nodes(),
+        [terminal_level, is_signed](const std::vector<bool>& bits) {
+            Integer value = 0;
+            for (std::size_t i = 0; i < bits.size(); i++)
+            {
+                if (bits[i])
+                {
+                    value += Integer(1) << i;
+                }
+            }
+            if (is_signed && bits.back())
+            {
+                value -= Integer(1) << bits.size();
+            }
+            return LevelMoments<Integer>{terminal_level, value, Integer(value * value)};
+        },
+        [](const LevelMoments<Integer>& then_moments, const LevelMoments<Integer>& else_moments) {
+            // the result is stated for the level directly above the higher child, the variables in
+            // between are skipped by both children and multiply their sums
+            const unsigned int level = std::min(then_moments.level, else_moments.level) - 1;
+            const Integer then_weight = Integer(1) << (then_moments.level - level - 1);
+            const Integer else_weight = Integer(1) << (else_moments.level - level - 1);
+            return LevelMoments<Integer>{
+                level, Integer(then_moments.sum * then_weight + else_moments.sum * else_weight),
+                Integer(then_moments.square_sum * then_weight +
+                        else_moments.square_sum * else_weight)};
+        });
+    if (!root)
+    {
+        return std::nullopt;
+    }
+    return std::make_pair(abo::util::to_cpp_int(root->sum) << root->level,
+                          abo::util::to_cpp_int(root->square_sum) << root->level);
+}
 
-    int max_support_size = 0;
-    for (const auto& bdd : f)
+ValueMoments value_moments(const std::vector<BDD>& f, const NumberRepresentation num_rep)
+{
+    if (f.empty())
     {
-        max_support_size = std::max(max_support_size, bdd.SupportSize());
+        return ValueMoments();
     }
 
-    for (unsigned int i = 0; i < f.size(); i++)
+    const abo::util::CompiledForest forest(f);
+    const bool is_signed = num_rep == NumberRepresentation::TwosComplement;
+    cpp_int sum;
+    cpp_int square_sum;
+    if (const auto sums = moment_sums<cpp_int>(forest, is_signed))
+    {
+        std::tie(sum, square_sum) = *sums;
+    }
+    else
     {
-        for (unsigned int b = i; b < f.size(); b++)
+        const std::vector<cpp_int> weights = bit_weights(f.size(), num_rep);
+        const std::vector<cpp_int> counts = forest.output_minterm_counts();
+        sum = 0;
+        for (std::size_t i = 0; i < f.size(); i++)
         {
-            // cudd handles the case i = b efficiently
-            BDD both = f[i] & f[b];
-            double minterms = both.CountMinterm(max_support_size);
-            // most terms (except for i == b), appear twice when factoring the square
-            uint256_t doubling_factor = i == b ? 1 : 2;
-            sum += (one << i) * (one << b) * uint256_t(minterms) *
-                   doubling_factor;
+            sum += weights[i] * counts[i];
         }
+        square_sum = pairwise_square_sum(f, weights);
     }
+    const cpp_int total = cpp_int(1) << forest.num_levels();
 
-    return cpp_dec_float_100(sum) /
-           cpp_dec_float_100(one << max_support_size);
+    // total^2 * variance = total * sum of squares - sum^2, which is exact in integers, so the
+    // difference of the two large moments does not cancel
+    const cpp_int spread = total * square_sum - sum * sum;
+    return ValueMoments{static_cast<double>(cpp_dec_float_100(sum) / cpp_dec_float_100(total)),
+                        static_cast<double>(cpp_dec_float_100(spread) /
+                                            cpp_dec_float_100(total * total))};
+}
+
+cpp_dec_float_100 mean_squared_value(const std::vector<BDD>& f)
+{
+    if (f.empty())
+    {
+        return 0;
+    }
+
+    const abo::util::CompiledForest forest(f);
+    // the squares are below 2^(2 * width), their sum below 2^(2 * width + levels)
+    const auto sums = abo::util::with_accumulator(
+        2 * f.size() + forest.num_levels() + 1,
+        [&forest](auto zero) { return moment_sums<decltype(zero)>(forest, false); });
+    const cpp_int square_sum =
+        sums ? sums->second
+             : pairwise_square_sum(f, bit_weights(f.size(), NumberRepresentation::BaseTwo));
+    return cpp_dec_float_100(square_sum) / cpp_dec_float_100(cpp_int(1) << forest.num_levels());
 }
 
 cpp_dec_float_100
@@ -67,10 +222,13 @@ average_case_error(const Cudd& mgr, const std::vector<BDD>& f,
                    const std::vector<BDD>& f_hat,
                    const util::NumberRepresentation num_rep)
 {
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return average_case_error(context);
+}
 
-    std::vector<BDD> absolute_difference =
-        abo::util::bdd_absolute_difference(mgr, f, f_hat, num_rep);
-    return average_value(absolute_difference);
+cpp_dec_float_100 average_case_error(MetricContext& context)
+{
+    return average_value(context.absolute_difference());
 }
 
 cpp_dec_float_100
@@ -78,10 +236,37 @@ mean_squared_error(const Cudd& mgr, const std::vector<BDD>& f,
                    const std::vector<BDD>& f_hat,
                    const util::NumberRepresentation num_rep)
 {
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return mean_squared_error(context);
+}
 
-    std::vector<BDD> absolute_difference =
-        abo::util::bdd_absolute_difference(mgr, f, f_hat, num_rep);
-    return mean_squared_value(absolute_difference);
+cpp_dec_float_100 mean_squared_error(MetricContext& context)
+{
+    return mean_squared_value(context.absolute_difference());
+}
+
+double error_bias(const Cudd& mgr, const std::vector<BDD>& f, const std::vector<BDD>& f_hat,
+                  const NumberRepresentation num_rep)
+{
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return error_bias(context);
+}
+
+double error_bias(MetricContext& context)
+{
+    return value_moments(context.difference(), NumberRepresentation::TwosComplement).mean;
+}
+
+double error_variance(const Cudd& mgr, const std::vector<BDD>& f, const std::vector<BDD>& f_hat,
+                      const NumberRepresentation num_rep)
+{
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return error_variance(context);
+}
+
+double error_variance(MetricContext& context)
+{
+    return value_moments(context.difference(), NumberRepresentation::TwosComplement).variance;
 }
 
 cpp_dec_float_100 average_case_error_add(const Cudd& mgr,
@@ -89,16 +274,32 @@ cpp_dec_float_100 average_case_error_add(const Cudd& mgr,
                                         const std::vector<BDD>& f_hat,
                                         const NumberRepresentation num_rep)
 {
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return average_case_error_add(context);
+}
+
+cpp_dec_float_100 average_case_error_add(MetricContext& context)
+{
+    if (context.needs_exact_terminals())
+    {
+        cpp_int sum = 0;
+        for (const auto& [value, count] :
+             abo::util::exact_add_terminal_values(context.exact_absolute_difference_add()))
+        {
+            sum += numerator(value) * count;
+        }
+        return cpp_dec_float_100(sum) /
+               cpp_dec_float_100(cpp_int(1) << context.manager().ReadSize());
+    }
 
-    ADD diff = abo::util::absolute_difference_add(mgr, f, f_hat, num_rep);
-    std::vector<std::pair<double, unsigned long>> terminal_values =
-        abo::util::add_terminal_values(diff);
+    std::vector<std::pair<double, cpp_int>> terminal_values =
+        abo::util::add_terminal_values(context.absolute_difference_add());
 
-    uint256_t sum = 0;
-    uint256_t path_sum = 0;
-    for (auto p : terminal_values)
+    cpp_int sum = 0;
+    cpp_int path_sum = 0;
+    for (const auto& p : terminal_values)
     {
-        sum += uint256_t(p.first) * p.second;
+        sum += cpp_int(p.first) * p.second;
         path_sum += p.second;
     }
     return cpp_dec_float_100(sum) /
@@ -110,16 +311,32 @@ cpp_dec_float_100 mean_squared_error_add(const Cudd& mgr,
                                         const std::vector<BDD>& f_hat,
                                         const NumberRepresentation num_rep)
 {
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return mean_squared_error_add(context);
+}
+
+cpp_dec_float_100 mean_squared_error_add(MetricContext& context)
+{
+    if (context.needs_exact_terminals())
+    {
+        cpp_int sum = 0;
+        for (const auto& [value, count] :
+             abo::util::exact_add_terminal_values(context.exact_absolute_difference_add()))
+        {
+            sum += numerator(value) * numerator(value) * count;
+        }
+        return cpp_dec_float_100(sum) /
+               cpp_dec_float_100(cpp_int(1) << context.manager().ReadSize());
+    }
 
-    ADD diff = abo::util::absolute_difference_add(mgr, f, f_hat, num_rep);
-    std::vector<std::pair<double, unsigned long>> terminal_values =
-        abo::util::add_terminal_values(diff);
+    std::vector<std::pair<double, cpp_int>> terminal_values =
+        abo::util::add_terminal_values(context.absolute_difference_add());
 
-    uint256_t sum = 0;
-    uint256_t path_sum = 0;
-    for (auto p : terminal_values)
+    cpp_int sum = 0;
+    cpp_int path_sum = 0;
+    for (const auto& p : terminal_values)
     {
-        uint256_t value(p.first);
+        cpp_int value(p.first);
         sum += value * value * p.second;
         path_sum += p.second;
     }
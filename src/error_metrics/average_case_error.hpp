@@ -4,20 +4,60 @@
 #include <cudd/cplusplus/cuddObj.hh>
 #include <vector>
 
+#include "metric_context.hpp"
 #include "number_representation.hpp"
 
 namespace abo::error_metrics {
 
 /**
  * @brief Computes the average value of the function f over all possible inputs
+ * The minterms of all bits are counted exactly, in one pass over the shared nodes
  * @param f The function to compute the average of
  * Is interpreted to be unsigned
  * @return the average value of f as a high precision float
  */
 boost::multiprecision::cpp_dec_float_100 average_value(const std::vector<BDD>& f);
 
+/**
+ * @brief The mean and the variance of the value of a function over all possible inputs
+ */
+struct ValueMoments
+{
+    //! The average value
+    double mean = 0;
+    //! The average squared deviation from the mean
+    double variance = 0;
+
+    //! Returns the average squared value
+    double mean_square() const
+    {
+        return variance + mean * mean;
+    }
+};
+
+/**
+ * @brief Computes the mean and the variance of the value of f over all possible inputs
+ *
+ * All bits of f are traversed jointly, bottom-up over the distinct joint cofactors of the bits
+ * (see abo::util::reduce_output_tuples). Every cofactor carries the exact sums of the value and of
+ * its square, which are the sums of its two children, so the cost is proportional to the number of
+ * cofactors instead of quadratic in the width. If there are more than a few cofactors per node of
+ * the forest, the square sum is taken from the conjunctions of all pairs of bits instead. The
+ * variance is computed from the exact sums before it is rounded, so it stays accurate for wide
+ * functions.
+ *
+ * @param f The function. Bit i has the significance 2^i
+ * @param num_rep The number representation of f. In Two's Complement, the last bit is the sign bit
+ * @return The mean and the variance of f
+ */
+ValueMoments value_moments(const std::vector<BDD>& f,
+                           const abo::util::NumberRepresentation num_rep =
+                               abo::util::NumberRepresentation::BaseTwo);
+
 /**
  * @brief Computes the average squared value of the function f over all possible inputs
+ * The squared values are summed exactly in one traversal of the joint cofactors of all bits like
+ * value_moments, with the same fallback to the conjunctions of all pairs of bits
  * @param f The function to compute the average squared value of
  * Is interpreted to be unsigned
  * @return the mean squared value of f as a high precision float
@@ -37,6 +77,13 @@ boost::multiprecision::cpp_dec_float_100
 average_case_error(const Cudd& mgr, const std::vector<BDD>& f, const std::vector<BDD>& f_hat,
                    const abo::util::NumberRepresentation num_rep = abo::util::NumberRepresentation::BaseTwo);
 
+/**
+ * @brief Computes the average case error of the functions of the context
+ * @param context The functions to compare. The absolute difference is taken from the context
+ * @return The average absolute difference between f and f_hat
+ */
+boost::multiprecision::cpp_dec_float_100 average_case_error(MetricContext& context);
+
 /**
  * @brief Computes the average squared absolute difference between the functions f and f_hat
  * The computation is performed symbolically with BDD forests and may take exponential time
@@ -52,6 +99,42 @@ mean_squared_error(const Cudd& mgr, const std::vector<BDD>& f,
                    const abo::util::NumberRepresentation num_rep
                         = abo::util::NumberRepresentation::BaseTwo);
 
+//! Computes mean_squared_error for the functions of the context
+boost::multiprecision::cpp_dec_float_100 mean_squared_error(MetricContext& context);
+
+/**
+ * @brief Computes the bias of f_hat, i.e. the average signed difference f - f_hat
+ * A positive bias means that f_hat underestimates f on average. The difference is computed as a
+ * BDD forest and evaluated with value_moments
+ * @param mgr Cudd manager object
+ * @param f The original function
+ * @param f_hat The approximated function
+ * @param num_rep The number representation for f and f_hat
+ * @return The average of f - f_hat
+ */
+double error_bias(const Cudd& mgr, const std::vector<BDD>& f, const std::vector<BDD>& f_hat,
+                  const abo::util::NumberRepresentation num_rep =
+                      abo::util::NumberRepresentation::BaseTwo);
+
+//! Computes error_bias for the functions of the context
+double error_bias(MetricContext& context);
+
+/**
+ * @brief Computes the variance of the signed difference f - f_hat over all inputs
+ * Together with the bias, it splits the mean squared error: MSE = bias^2 + variance
+ * @param mgr Cudd manager object
+ * @param f The original function
+ * @param f_hat The approximated function
+ * @param num_rep The number representation for f and f_hat
+ * @return The variance of f - f_hat
+ */
+double error_variance(const Cudd& mgr, const std::vector<BDD>& f, const std::vector<BDD>& f_hat,
+                      const abo::util::NumberRepresentation num_rep =
+                          abo::util::NumberRepresentation::BaseTwo);
+
+//! Computes error_variance for the functions of the context
+double error_variance(MetricContext& context);
+
 /**
  * @brief Computes the average absolute difference between the functions f and f_hat
  * The computation is performed symbolically with ADDs and may take exponential time
@@ -69,6 +152,9 @@ average_case_error_add(const Cudd& mgr, const std::vector<BDD>& f,
                        const abo::util::NumberRepresentation num_rep
                             = abo::util::NumberRepresentation::BaseTwo);
 
+//! Computes average_case_error_add for the functions of the context, reusing its ADD
+boost::multiprecision::cpp_dec_float_100 average_case_error_add(MetricContext& context);
+
 /**
  * @brief Computes the average squared absolute difference between the functions f and f_hat
  * The computation is performed symbolically with ADDs and may take exponential time
@@ -86,4 +172,7 @@ mean_squared_error_add(const Cudd& mgr, const std::vector<BDD>& f,
                        const abo::util::NumberRepresentation num_rep
                             = abo::util::NumberRepresentation::BaseTwo);
 
+//! Computes mean_squared_error_add for the functions of the context, reusing its ADD
+boost::multiprecision::cpp_dec_float_100 mean_squared_error_add(MetricContext& context);
+
 } // namespace abo::error_metrics
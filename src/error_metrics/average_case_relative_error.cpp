@@ -5,6 +5,7 @@
 
 using abo::util::NumberRepresentation;
 using boost::multiprecision::cpp_dec_float_100;
+using boost::multiprecision::cpp_int;
 using boost::multiprecision::uint256_t;
 
 namespace abo::error_metrics {
@@ -44,11 +45,14 @@ std::pair<cpp_dec_float_100, cpp_dec_float_100>
               const std::vector<BDD>& f_hat,
               const util::NumberRepresentation num_rep)
 {
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return acre_bounds(context);
+}
 
-    std::vector<BDD> absolute_difference =
-        abo::util::bdd_absolute_difference(mgr, f, f_hat, num_rep);
-    std::vector<BDD> f_absolute = abo::util::bdd_abs(mgr, f, num_rep);
-    return average_relative_value(mgr, absolute_difference, f_absolute);
+std::pair<cpp_dec_float_100, cpp_dec_float_100> acre_bounds(MetricContext& context)
+{
+    return average_relative_value(context.manager(), context.absolute_difference(),
+                                  context.original_absolute());
 }
 
 cpp_dec_float_100
@@ -57,20 +61,21 @@ cpp_dec_float_100
             const std::vector<BDD>& f_hat,
             const NumberRepresentation num_rep)
 {
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return acre_add(context);
+}
 
-    ADD diff = abo::util::absolute_difference_add(mgr, f, f_hat, num_rep);
-    std::vector<BDD> f_absolute = abo::util::bdd_abs(mgr, f, num_rep);
-    ADD respective_diff = diff.Divide(
-        abo::util::bdd_forest_to_add(mgr, f_absolute).Maximum(mgr.addOne()));
-    std::vector<std::pair<double, unsigned long>> terminal_values =
-        abo::util::add_terminal_values(respective_diff);
+cpp_dec_float_100 acre_add(MetricContext& context)
+{
+    std::vector<std::pair<double, cpp_int>> terminal_values =
+        abo::util::add_terminal_values(context.relative_difference_add());
 
     cpp_dec_float_100 sum = 0;
-    uint256_t path_sum = 0;
-    for (auto p : terminal_values)
+    cpp_int path_sum = 0;
+    for (const auto& p : terminal_values)
     {
         cpp_dec_float_100 value(p.first);
-        sum += value * p.second;
+        sum += value * cpp_dec_float_100(p.second);
         path_sum += p.second;
     }
     return cpp_dec_float_100(sum) /
@@ -84,15 +89,15 @@ cpp_dec_float_100
                             unsigned int num_extra_bits,
                             const NumberRepresentation num_rep)
 {
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return acre_symbolic_division(context, num_extra_bits);
+}
 
-    std::vector<BDD> absolute_difference =
-        abo::util::bdd_absolute_difference(mgr, f, f_hat, num_rep);
-
-    std::vector<BDD> f_absolute = abo::util::bdd_abs(mgr, f, num_rep);
-    std::vector<BDD> no_zero = abo::util::bdd_max_one(mgr, f_absolute);
+cpp_dec_float_100 acre_symbolic_division(MetricContext& context, unsigned int num_extra_bits)
+{
     std::vector<BDD> divided =
-        abo::util::bdd_divide(mgr, absolute_difference,
-                              no_zero, num_extra_bits);
+        abo::util::bdd_divide(context.manager(), context.absolute_difference(),
+                              context.original_absolute_max_one(), num_extra_bits);
 
     return average_value(divided) / std::pow(2.0, num_extra_bits);
 }
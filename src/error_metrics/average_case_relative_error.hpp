@@ -4,6 +4,7 @@
 #include <cudd/cplusplus/cuddObj.hh>
 #include <vector>
 
+#include "metric_context.hpp"
 #include "number_representation.hpp"
 
 namespace abo::error_metrics {
@@ -28,6 +29,11 @@ std::pair<boost::multiprecision::cpp_dec_float_100,
                   const abo::util::NumberRepresentation num_rep
                         = abo::util::NumberRepresentation::BaseTwo);
 
+//! Computes acre_bounds for the functions of the context
+std::pair<boost::multiprecision::cpp_dec_float_100,
+            boost::multiprecision::cpp_dec_float_100>
+    acre_bounds(MetricContext& context);
+
 /**
  * @brief Computes the average relative difference between f and f_hat
  * It is defined as the average of |f(x) - f_hat(x)| / max(1, |f(x)|) for all inputs x
@@ -45,6 +51,9 @@ boost::multiprecision::cpp_dec_float_100
            const abo::util::NumberRepresentation num_rep
                 = abo::util::NumberRepresentation::BaseTwo);
 
+//! Computes acre_add for the functions of the context, reusing its ADDs
+boost::multiprecision::cpp_dec_float_100 acre_add(MetricContext& context);
+
 /**
  * @brief Computes the average relative difference between f and f_hat
  * It is defined as the average of |f(x) - f_hat(x)| / max(1, |f(x)|) for all inputs x
@@ -65,4 +74,9 @@ boost::multiprecision::cpp_dec_float_100 acre_symbolic_division(
     unsigned int num_extra_bits = 16,
     const abo::util::NumberRepresentation num_rep
         = abo::util::NumberRepresentation::BaseTwo);
+
+//! Computes acre_symbolic_division for the functions of the context
+boost::multiprecision::cpp_dec_float_100 acre_symbolic_division(MetricContext& context,
+                                                                unsigned int num_extra_bits = 16);
+
 } // namespace abo::error_metrics
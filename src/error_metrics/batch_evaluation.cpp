@@ -0,0 +1,130 @@
+#include "batch_evaluation.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace abo::error_metrics {
+
+/**
+ * @brief Returns count variables that none of the functions depend on, preferring the top of the
+ * order
+ *
+ * All variables of the manager that the functions do not depend on form the pool of selector
+ * variables, including the ones created by earlier calls. New variables are only created at the
+ * top if the pool is too small, so the manager grows by at most the largest count over all calls.
+ */
+static std::vector<BDD> selector_variables(const Cudd& mgr,
+                                           const std::vector<std::vector<BDD>>& functions,
+                                           std::size_t count)
+{
+    std::vector<bool> in_support(static_cast<std::size_t>(mgr.ReadSize()), false);
+    for (const auto& f : functions)
+    {
+        for (unsigned int index : mgr.SupportIndices(f))
+        {
+            in_support[index] = true;
+        }
+    }
+
+    std::vector<BDD> result;
+    for (int level = 0; level < mgr.ReadSize() && result.size() < count; level++)
+    {
+        const int index = mgr.ReadInvPerm(level);
+        if (!in_support[static_cast<std::size_t>(index)])
+        {
+            result.push_back(mgr.bddVar(index));
+        }
+    }
+    while (result.size() < count)
+    {
+        result.push_back(mgr.bddNewVarAtLevel(0));
+    }
+    return result;
+}
+
+//! Returns the cube that selects the candidate with the given index
+static BDD selection_cube(const Cudd& mgr, const std::vector<BDD>& selectors, std::size_t index)
+{
+    BDD cube = mgr.bddOne();
+    for (std::size_t s = 0; s < selectors.size(); s++)
+    {
+        cube &= ((index >> s) & 1) ? selectors[s] : !selectors[s];
+    }
+    return cube;
+}
+
+/**
+ * @brief Returns the forest that equals candidate j if the selectors encode j
+ *
+ * Selector s decides bit s of the index. Indices beyond the last candidate select the last one.
+ */
+static std::vector<BDD> multiplex(const std::vector<BDD>& selectors,
+                                  const std::vector<std::vector<BDD>>& candidates)
+{
+    std::vector<BDD> result;
+    for (std::size_t bit = 0; bit < candidates.front().size(); bit++)
+    {
+        std::vector<BDD> layer(std::size_t(1) << selectors.size());
+        for (std::size_t j = 0; j < layer.size(); j++)
+        {
+            layer[j] = candidates[std::min(j, candidates.size() - 1)][bit];
+        }
+        for (const BDD& selector : selectors)
+        {
+            for (std::size_t j = 0; j < layer.size() / 2; j++)
+            {
+                layer[j] = selector.Ite(layer[2 * j + 1], layer[2 * j]);
+            }
+            layer.resize(layer.size() / 2);
+        }
+        result.push_back(layer.front());
+    }
+    return result;
+}
+
+std::vector<MetricContext> candidate_contexts(const std::shared_ptr<PreparedOriginal>& original,
+                                              const std::vector<std::vector<BDD>>& candidates)
+{
+    std::vector<MetricContext> result;
+    if (candidates.empty())
+    {
+        return result;
+    }
+
+    const Cudd& mgr = original->manager();
+    std::size_t selector_count = 0;
+    while ((std::size_t(1) << selector_count) < candidates.size())
+    {
+        selector_count++;
+    }
+
+    std::vector<std::vector<BDD>> functions = candidates;
+    functions.push_back(original->function());
+    const std::vector<BDD> selectors = selector_variables(mgr, functions, selector_count);
+
+    auto batch = std::make_shared<MetricContext>(original, multiplex(selectors, candidates));
+    result.reserve(candidates.size());
+    for (std::size_t j = 0; j < candidates.size(); j++)
+    {
+        assert(candidates[j].size() == original->function().size());
+        result.emplace_back(original, candidates[j]);
+        result.back().set_batch_selection(batch, selection_cube(mgr, selectors, j));
+    }
+    return result;
+}
+
+std::vector<double> evaluate_candidates(const Cudd& mgr, const std::vector<BDD>& f,
+                                        const std::vector<std::vector<BDD>>& candidates,
+                                        const std::function<double(MetricContext&)>& metric,
+                                        const abo::util::NumberRepresentation num_rep)
+{
+    auto original = std::make_shared<PreparedOriginal>(mgr, f, num_rep);
+    std::vector<double> result;
+    for (MetricContext& context : candidate_contexts(original, candidates))
+    {
+        result.push_back(metric(context));
+    }
+    return result;
+}
+
+} // namespace abo::error_metrics
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cudd/cplusplus/cuddObj.hh>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "metric_context.hpp"
+#include "number_representation.hpp"
+
+namespace abo::error_metrics {
+
+/**
+ * @brief Creates the metric contexts of many candidate approximations that share one subtractor
+ *
+ * The candidates are multiplexed into a single forest with ceil(log2 k) selector variables above
+ * all variables of the functions. The differences to the original function are then only built
+ * for the multiplexed forest and the difference of every candidate is its cofactor for the
+ * selector values of the candidate. As the candidates of population based searches are nearly
+ * identical, the multiplexed forest is hardly larger than a single candidate and the computed
+ * table of CUDD shares most of the work.
+ *
+ * The variables that none of the functions depend on are used as selector variables, the ones at
+ * the top of the order first. New variables are only created at the top when there are not enough
+ * of them, and as they stay unused afterwards, later calls reuse them. The manager therefore grows
+ * by at most ceil(log2 k) variables for the largest k over all calls. Every added variable changes
+ * ReadSize(), which doubles the counts over all variables of the manager, e.g. the totals of a
+ * ValueDistribution. Fractions and averages, i.e. all metrics, are unchanged.
+ *
+ * @param original The original function
+ * @param candidates The approximations. Each must have the same number of bits as the original
+ * function
+ * @return One context per candidate, in the same order
+ */
+std::vector<MetricContext>
+candidate_contexts(const std::shared_ptr<PreparedOriginal>& original,
+                   const std::vector<std::vector<BDD>>& candidates);
+
+/**
+ * @brief Evaluates a metric for many candidate approximations that share their intermediate
+ * results
+ *
+ * See candidate_contexts. Only the intermediate results of the contexts, e.g. the differences and
+ * their ADDs, are computed once for all candidates. The metric itself is still called once per
+ * candidate on the cofactors, so only the part of its work that builds these results is shared.
+ *
+ * @param mgr The BDD object manager
+ * @param f The original function
+ * @param candidates The approximations. Each must have the same number of bits as f
+ * @param metric The metric to compute, e.g. one of the functions taking a MetricContext
+ * @param num_rep The number representation for f and the candidates
+ * @return The value of the metric for every candidate, in the same order
+ */
+std::vector<double> evaluate_candidates(
+    const Cudd& mgr, const std::vector<BDD>& f, const std::vector<std::vector<BDD>>& candidates,
+    const std::function<double(MetricContext&)>& metric,
+    const abo::util::NumberRepresentation num_rep = abo::util::NumberRepresentation::BaseTwo);
+
+} // namespace abo::error_metrics
@@ -0,0 +1,95 @@
+#include "compute_metrics.hpp"
+
+#include <numeric>
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+#include "average_case_error.hpp"
+#include "compiled_forest.hpp"
+#include "worst_case_bit_flip_error.hpp"
+
+using abo::util::CompiledForest;
+using abo::util::NumberRepresentation;
+using boost::multiprecision::cpp_int;
+using boost::multiprecision::cpp_rational;
+
+namespace abo::error_metrics {
+
+MetricValues compute_metrics(const Cudd& mgr, const std::vector<BDD>& f,
+                             const std::vector<BDD>& f_hat, const MetricSet& metrics,
+                             const NumberRepresentation num_rep)
+{
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return compute_metrics(context, metrics);
+}
+
+MetricValues compute_metrics(MetricContext& context, const MetricSet& metrics)
+{
+    const bool use_miter = metrics.error_rate || metrics.average_bit_flip_error;
+    const bool use_difference = metrics.average_case_error;
+
+    // the forest consists of the miter bits, the difference bits and the disjunction of the miter
+    std::vector<BDD> forest;
+    if (use_miter)
+    {
+        forest = context.miter();
+    }
+    const std::size_t num_miter = forest.size();
+    if (use_difference)
+    {
+        const std::vector<BDD>& difference = context.absolute_difference();
+        forest.insert(forest.end(), difference.begin(), difference.end());
+    }
+    const std::size_t num_difference = forest.size() - num_miter;
+    if (metrics.error_rate)
+    {
+        BDD any_error = context.manager().bddZero();
+        for (std::size_t i = 0; i < num_miter; i++)
+        {
+            any_error |= forest[i];
+        }
+        forest.push_back(any_error);
+    }
+
+    // the counts are exact, so the results equal those of the separate metrics
+    const CompiledForest compiled(forest);
+    const std::vector<cpp_int> counts = compiled.output_minterm_counts();
+    const cpp_int total = cpp_int(1) << compiled.num_levels();
+    auto average = [&total](const cpp_int& sum) {
+        return static_cast<double>(cpp_rational(sum, total));
+    };
+
+    MetricValues result;
+    if (metrics.error_rate)
+    {
+        result.error_rate = average(counts.back());
+    }
+    if (metrics.average_bit_flip_error)
+    {
+        result.average_bit_flip_error =
+            average(std::accumulate(counts.begin(), counts.begin() + num_miter, cpp_int(0)));
+    }
+    if (metrics.average_case_error)
+    {
+        cpp_int sum = 0;
+        for (std::size_t i = 0; i < num_difference; i++)
+        {
+            sum += counts[num_miter + i] << i;
+        }
+        result.average_case_error = average(sum);
+    }
+
+    // both couple several bits, they reuse the miter and the difference of the context
+    if (metrics.worst_case_bit_flip_error)
+    {
+        result.worst_case_bit_flip_error = worst_case_bit_flip_error(context);
+    }
+    if (metrics.mean_squared_error)
+    {
+        result.mean_squared_error = static_cast<double>(mean_squared_error(context));
+    }
+
+    return result;
+}
+
+} // namespace abo::error_metrics
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cudd/cplusplus/cuddObj.hh>
+#include <vector>
+
+#include "metric_context.hpp"
+#include "number_representation.hpp"
+
+namespace abo::error_metrics {
+
+//! Selects the metrics computed by compute_metrics
+struct MetricSet
+{
+    bool error_rate = false;
+    bool average_bit_flip_error = false;
+    bool worst_case_bit_flip_error = false;
+    bool average_case_error = false;
+    bool mean_squared_error = false;
+
+    //! Returns the set of all metrics supported by compute_metrics
+    static MetricSet all()
+    {
+        return {true, true, true, true, true};
+    }
+};
+
+//! The results of compute_metrics. Metrics that were not requested are zero
+struct MetricValues
+{
+    double error_rate = 0;
+    double average_bit_flip_error = 0;
+    unsigned int worst_case_bit_flip_error = 0;
+    double average_case_error = 0;
+    double mean_squared_error = 0;
+};
+
+/**
+ * @brief Computes several error metrics of f_hat at once
+ *
+ * The miter f[i] ^ f_hat[i] and the absolute difference |f - f_hat| are built once in the context
+ * and shared by all metrics. The error rate, the average bit flip error and the average case error
+ * only depend on the number of inputs for which each output is one. These are counted exactly for
+ * all outputs in one pass over the shared nodes of a single compiled forest, so the results equal
+ * those of error_rate, average_bit_flip_error and average_case_error. The worst case bit flip error
+ * and the mean squared error depend on several outputs jointly and are computed like
+ * worst_case_bit_flip_error and mean_squared_error, on the shared miter and difference.
+ *
+ * @param mgr The BDD object manager
+ * @param f The original function
+ * @param f_hat The approximated function. Must have the same number of bits as f
+ * @param metrics The metrics to compute
+ * @param num_rep The number representation for f and f_hat
+ * @return The values of the requested metrics
+ */
+MetricValues compute_metrics(const Cudd& mgr, const std::vector<BDD>& f,
+                             const std::vector<BDD>& f_hat,
+                             const MetricSet& metrics = MetricSet::all(),
+                             const abo::util::NumberRepresentation num_rep =
+                                 abo::util::NumberRepresentation::BaseTwo);
+
+//! Computes compute_metrics for the functions of the context, reusing its miter and difference
+MetricValues compute_metrics(MetricContext& context, const MetricSet& metrics = MetricSet::all());
+
+} // namespace abo::error_metrics
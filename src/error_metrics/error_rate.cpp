@@ -3,7 +3,20 @@
 //
 
 #include "error_rate.hpp"
+#include "bit_parallel_evaluation.hpp"
+#include "compiled_forest.hpp"
 #include "cudd_helpers.hpp"
+#include "incremental_metrics.hpp"
+#include "parallel_sampling.hpp"
+#include "random.hpp"
+#include "satisfying_input_sampler.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+using boost::multiprecision::cpp_int;
+using boost::multiprecision::cpp_rational;
 
 namespace abo::error_metrics {
 
@@ -11,62 +24,84 @@ double error_rate(const Cudd& mgr,
                   const std::vector<BDD>& f,
                   const std::vector<BDD>& f_hat)
 {
+    MetricContext context(mgr, f, f_hat);
+    return error_rate(context);
+}
 
-    BDD miter_bdd = mgr.bddZero();
-
-    // maybe: use some kind of zip function as soon as C++ actually supports that in a non-ugly
-    // fassion
-    for (std::size_t i = 0; i < f.size(); i++)
+double error_rate(MetricContext& context)
+{
+    if (IncrementalMetrics* base = context.single_output_base())
     {
-        miter_bdd = miter_bdd | (f[i] ^ f_hat[i]);
+        const std::size_t output = context.changed_output();
+        return base->error_rate(output, context.approximation()[output]);
     }
 
-    DdManager* dd = mgr.getManager();
+    const Cudd& mgr = context.manager();
+    BDD miter_bdd = mgr.bddZero();
+    for (const BDD& b : context.miter())
+    {
+        miter_bdd = miter_bdd | b;
+    }
 
-    unsigned int num_variables = abo::util::terminal_level({f, f_hat}) - 1;
-    double minterms = Cudd_CountMinterm(dd, miter_bdd.getNode(), num_variables);
-    return minterms / std::pow(2.0, num_variables);
+    const abo::util::CompiledForest forest({miter_bdd});
+    return static_cast<double>(cpp_rational(forest.output_minterm_counts().front(),
+                                            cpp_int(1) << forest.num_levels()));
 }
 
-double error_rate_sampling(const Cudd& mgr,
+double error_rate_sampling([[maybe_unused]] const Cudd& mgr,
                            const std::vector<BDD>& f,
                            const std::vector<BDD>& f_hat,
-                           long samples)
+                           long samples, std::uint64_t seed, unsigned int threads)
 {
     assert(f.size() == f_hat.size());
-    std::vector<BDD> difference;
-
-    difference.reserve(f.size());
-    for (unsigned int i = 0; i < f.size(); i++)
-    {
-        difference.push_back(f[i] ^ f_hat[i]);
-    }
-
-    unsigned int terminal_level = mgr.ReadSize();
-
-    long error_samples = 0;
-    std::vector<int> inputs(terminal_level, 0);
-    for (int i = 0; i < samples; i++)
-    {
-        std::generate(inputs.begin(), inputs.end(), []() {
-            return rand() % 2;
-        });
-        for (const BDD& b : difference)
-        {
-            if (b.Eval(inputs.data()).IsOne())
+    using abo::util::BitParallelEvaluator;
+    using Word = BitParallelEvaluator::Word;
+    constexpr std::size_t block_words = BitParallelEvaluator::words_per_block;
+
+    // f and f_hat are evaluated directly, which avoids building the miter symbolically
+    std::vector<BDD> forest = f;
+    forest.insert(forest.end(), f_hat.begin(), f_hat.end());
+    const abo::util::CompiledForest compiled(forest);
+
+    const std::size_t num_chunks = abo::util::sample_chunk_count(samples);
+    std::vector<long> chunk_errors(num_chunks, 0);
+    abo::util::parallel_chunks(num_chunks, threads, [&]() {
+        return [&, evaluator = BitParallelEvaluator(compiled),
+                inputs = std::vector<Word>(compiled.num_inputs() * block_words),
+                outputs = std::vector<Word>(forest.size() * block_words)](
+                   std::size_t chunk) mutable {
+            abo::util::Xoshiro256StarStar generator(seed, chunk);
+            const std::size_t chunk_samples = abo::util::samples_in_chunk(samples, chunk);
+            for (std::size_t block_start = 0; block_start < chunk_samples;
+                 block_start += BitParallelEvaluator::block_size)
             {
-                error_samples++;
-                break;
+                std::generate(inputs.begin(), inputs.end(), std::ref(generator));
+                evaluator.evaluate(inputs.data(), outputs.data());
+
+                const std::size_t block_samples = chunk_samples - block_start;
+                for (std::size_t w = 0; w < block_words; w++)
+                {
+                    Word differs = 0;
+                    for (std::size_t i = 0; i < f.size(); i++)
+                    {
+                        differs |= outputs[i * block_words + w] ^
+                                   outputs[(f.size() + i) * block_words + w];
+                    }
+                    differs &= abo::util::valid_samples_mask(block_samples, w);
+                    chunk_errors[chunk] += __builtin_popcountll(differs);
+                }
             }
-        }
-    }
+        };
+    });
+
+    const long error_samples = std::accumulate(chunk_errors.begin(), chunk_errors.end(), 0L);
     return static_cast<double>(error_samples) / samples;
 }
 
 double error_rate_efficient_sampling(const Cudd& mgr,
                                      const std::vector<BDD>& f,
                                      const std::vector<BDD>& f_hat,
-                                     long samples)
+                                     long samples, std::uint64_t seed, unsigned int threads)
 {
     assert(f.size() == f_hat.size());
     std::vector<BDD> difference;
@@ -98,42 +133,84 @@ double error_rate_efficient_sampling(const Cudd& mgr,
                   return a.second > b.second;
               });
 
-    double actual_rate = activations[0].second;
+    using abo::util::BitParallelEvaluator;
+    using Word = BitParallelEvaluator::Word;
+    constexpr std::size_t block_words = BitParallelEvaluator::words_per_block;
+
+    const abo::util::CompiledForest compiled(difference);
+
+    // for every difference i, inputs for which it is set are drawn and those for which no
+    // difference with a higher activation is set are counted. The chunks of all differences are
+    // processed together, chunk number k drawing from random number stream k
+    struct Chunk
+    {
+        unsigned int activation;
+        std::size_t samples;
+    };
+    std::vector<Chunk> chunks;
+    // the minterm fractions and thresholds are computed once for all differences. The difference
+    // with the highest activation is counted exactly and needs no sampler, samplers[i - 1] belongs
+    // to difference i
+    const abo::util::SamplingThresholds thresholds(compiled);
+    std::vector<abo::util::SatisfyingInputSampler> samplers;
+    std::vector<long> index_samples(difference.size(), 0);
+    samplers.reserve(difference.size());
     for (unsigned int i = 1; i < difference.size(); i++)
     {
-        long index_samples =
-            samples * activations[i].second /
-                (maximum_rate - activations[0].second);
-        if (index_samples == 0)
+        samplers.emplace_back(thresholds, activations[i].first);
+        index_samples[i] = samples * activations[i].second / (maximum_rate - activations[0].second);
+        for (std::size_t c = 0; c < abo::util::sample_chunk_count(index_samples[i]); c++)
         {
-            continue;
+            chunks.push_back({i, abo::util::samples_in_chunk(index_samples[i], c)});
         }
+    }
 
-        std::map<DdNode*, double> minterm_count =
-            abo::util::count_minterms(difference[activations[i].first]);
-        long good_samples = 0;
-        for (int b = 0; b < index_samples; b++)
-        {
-            BDD diff = difference[activations[i].first];
-            std::vector<int> input = abo::util::random_satisfying_input(
-                diff, minterm_count, terminal_level);
-            bool found = false;
-            for (unsigned int j = 0; j < i; j++)
+    std::vector<long> chunk_good_samples(chunks.size(), 0);
+    abo::util::parallel_chunks(chunks.size(), threads, [&]() {
+        return [&, evaluator = BitParallelEvaluator(compiled),
+                inputs = std::vector<Word>(compiled.num_inputs() * block_words),
+                outputs = std::vector<Word>(difference.size() * block_words)](
+                   std::size_t chunk) mutable {
+            abo::util::Xoshiro256StarStar generator(seed, chunk);
+            const unsigned int i = chunks[chunk].activation;
+            for (std::size_t block_start = 0; block_start < chunks[chunk].samples;
+                 block_start += BitParallelEvaluator::block_size)
             {
-                BDD value = difference[activations[j].first].Eval(input.data());
-                if (value.IsOne())
+                const std::size_t block_samples = std::min(BitParallelEvaluator::block_size,
+                                                           chunks[chunk].samples - block_start);
+                samplers[i - 1].sample(generator, block_samples, compiled.num_inputs(),
+                                       inputs.data());
+                evaluator.evaluate(inputs.data(), outputs.data());
+
+                for (std::size_t w = 0; w < block_words; w++)
                 {
-                    found = true;
-                    break;
+                    Word found = 0;
+                    for (unsigned int j = 0; j < i; j++)
+                    {
+                        found |= outputs[activations[j].first * block_words + w];
+                    }
+                    const Word good = ~found & abo::util::valid_samples_mask(block_samples, w);
+                    chunk_good_samples[chunk] += __builtin_popcountll(good);
                 }
             }
-            if (!found)
-            {
-                good_samples++;
-            }
+        };
+    });
+
+    std::vector<long> good_samples(difference.size(), 0);
+    for (std::size_t c = 0; c < chunks.size(); c++)
+    {
+        good_samples[chunks[c].activation] += chunk_good_samples[c];
+    }
+
+    double actual_rate = activations[0].second;
+    for (unsigned int i = 1; i < difference.size(); i++)
+    {
+        if (index_samples[i] == 0)
+        {
+            continue;
         }
-        double good_fraction = static_cast<double>(good_samples)
-                / static_cast<double>(index_samples);
+        double good_fraction = static_cast<double>(good_samples[i])
+                / static_cast<double>(index_samples[i]);
         actual_rate += activations[i].second * good_fraction;
     }
 
@@ -144,12 +221,17 @@ double error_rate_add(const Cudd& mgr,
                       const std::vector<BDD>& f,
                       const std::vector<BDD>& f_hat)
 {
-    ADD diff = abo::util::xor_difference_add(mgr, f, f_hat);
-    std::vector<std::pair<double, unsigned long>> terminal_values =
-        abo::util::add_terminal_values(diff);
-    unsigned long non_zero_path_count = 0;
-    unsigned long total_path_count = 0;
-    for (auto [value, path_count] : terminal_values)
+    MetricContext context(mgr, f, f_hat);
+    return error_rate_add(context);
+}
+
+double error_rate_add(MetricContext& context)
+{
+    std::vector<std::pair<double, cpp_int>> terminal_values =
+        abo::util::add_terminal_values(context.xor_difference_add());
+    cpp_int non_zero_path_count = 0;
+    cpp_int total_path_count = 0;
+    for (const auto& [value, path_count] : terminal_values)
     {
         if (value != 0)
         {
@@ -157,7 +239,7 @@ double error_rate_add(const Cudd& mgr,
         }
         total_path_count += path_count;
     }
-    return non_zero_path_count / static_cast<double>(total_path_count);
+    return static_cast<double>(cpp_rational(non_zero_path_count, total_path_count));
 }
 
 double error_rate(const Cudd& mgr,
@@ -4,11 +4,14 @@
 
 #pragma once
 
+#include <cstdint>
 #include <cudd/cplusplus/cuddObj.hh>
 #include <vector>
 
 #include <boost/multiprecision/cpp_int.hpp>
 
+#include "metric_context.hpp"
+
 namespace abo::error_metrics {
 
 /**
@@ -28,6 +31,9 @@ double error_rate(const Cudd& mgr,
                   const BDD& f,
                   const BDD& f_hat);
 
+//! Computes the error rate of the functions of the context, reusing its miter
+double error_rate(MetricContext& context);
+
 /**
  * @brief Computes the error rate, i.e. the number of inputs for which f_hat differs from f
  * The result is scaled to lie between 0 and 1
@@ -42,6 +48,9 @@ double error_rate_add(const Cudd& mgr,
                       const std::vector<BDD>& f,
                       const std::vector<BDD>& f_hat);
 
+//! Computes error_rate_add for the functions of the context, reusing its XOR ADD
+double error_rate_add(MetricContext& context);
+
 /**
  * @brief Approximates the error rate, i.e. the number of inputs for which f_hat differs from f
  * The result is scaled to lie between 0 and 1
@@ -50,12 +59,17 @@ double error_rate_add(const Cudd& mgr,
  * @param f The original function
  * @param f_hat The approximated function. Must have the same number of bits as f
  * @param samples The number of samples to use
+ * @param seed The seed of the random number generator. The same seed always gives the same result,
+ * independent of the number of threads
+ * @param threads The number of threads to evaluate the samples with. Zero uses all hardware threads
  * @return The approximated error rate in the interval [0, 1]
  */
 double error_rate_sampling(const Cudd& mgr,
                            const std::vector<BDD>& f,
                            const std::vector<BDD>& f_hat,
-                           long samples = 10000);
+                           long samples = 10000,
+                           std::uint64_t seed = 0,
+                           unsigned int threads = 1);
 
 /**
  * @brief Approximates the error rate, i.e. the number of inputs for which f_hat differs from f
@@ -66,10 +80,15 @@ double error_rate_sampling(const Cudd& mgr,
  * @param f The original function
  * @param f_hat The approximated function. Must have the same number of bits as f
  * @param samples The number of samples to use
+ * @param seed The seed of the random number generator. The same seed always gives the same result,
+ * independent of the number of threads
+ * @param threads The number of threads to evaluate the samples with. Zero uses all hardware threads
  * @return The approximated error rate in the interval [0, 1]
  */
 double error_rate_efficient_sampling(const Cudd& mgr,
                                      const std::vector<BDD>& f,
                                      const std::vector<BDD>& f_hat,
-                                     long samples = 10000);
+                                     long samples = 10000,
+                                     std::uint64_t seed = 0,
+                                     unsigned int threads = 1);
 } // namespace abo::error_metrics
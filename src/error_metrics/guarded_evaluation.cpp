@@ -0,0 +1,76 @@
+#include "guarded_evaluation.hpp"
+
+#include "average_case_error.hpp"
+#include "error_rate.hpp"
+
+using abo::util::ComputationAborted;
+using abo::util::ComputationBudget;
+using abo::util::ManagerLimits;
+
+namespace abo::error_metrics {
+
+GuardedResult guarded_evaluation(const Cudd& mgr, const ComputationBudget& budget,
+                                 const std::function<double()>& exact,
+                                 const std::function<SamplingResult()>& estimate)
+{
+    try
+    {
+        // the limits must be lifted again before the estimate is computed
+        ManagerLimits limits(mgr, budget);
+        const double value = exact();
+        return {true, value, value, value, 0};
+    }
+    catch (const ComputationAborted&)
+    {
+    }
+
+    const SamplingResult result = estimate();
+    return {false, result.estimate, result.lower_bound, result.upper_bound, result.samples};
+}
+
+GuardedResult guarded_error_rate(const Cudd& mgr, const std::vector<BDD>& f,
+                                 const std::vector<BDD>& f_hat, const ComputationBudget& budget,
+                                 double confidence, double half_width, std::uint64_t seed,
+                                 unsigned int threads)
+{
+    return guarded_evaluation(
+        mgr, budget, [&]() { return error_rate(mgr, f, f_hat); },
+        [&]() {
+            return error_rate_sequential_sampling(mgr, f, f_hat, confidence, half_width, 1L << 30,
+                                                  seed, threads);
+        });
+}
+
+GuardedResult guarded_average_case_error(const Cudd& mgr, const std::vector<BDD>& f,
+                                         const std::vector<BDD>& f_hat,
+                                         const ComputationBudget& budget, double confidence,
+                                         double half_width,
+                                         const abo::util::NumberRepresentation num_rep,
+                                         std::uint64_t seed, unsigned int threads)
+{
+    return guarded_evaluation(
+        mgr, budget,
+        [&]() { return static_cast<double>(average_case_error(mgr, f, f_hat, num_rep)); },
+        [&]() {
+            return average_case_error_sequential_sampling(mgr, f, f_hat, confidence, half_width,
+                                                          1L << 30, 0, num_rep, seed, threads);
+        });
+}
+
+GuardedResult guarded_mean_squared_error(const Cudd& mgr, const std::vector<BDD>& f,
+                                         const std::vector<BDD>& f_hat,
+                                         const ComputationBudget& budget, double confidence,
+                                         double half_width,
+                                         const abo::util::NumberRepresentation num_rep,
+                                         std::uint64_t seed, unsigned int threads)
+{
+    return guarded_evaluation(
+        mgr, budget,
+        [&]() { return static_cast<double>(mean_squared_error(mgr, f, f_hat, num_rep)); },
+        [&]() {
+            return mean_squared_error_sequential_sampling(mgr, f, f_hat, confidence, half_width,
+                                                          1L << 30, 0, num_rep, seed, threads);
+        });
+}
+
+} // namespace abo::error_metrics
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <cudd/cplusplus/cuddObj.hh>
+#include <functional>
+#include <vector>
+
+#include "computation_budget.hpp"
+#include "number_representation.hpp"
+#include "sequential_sampling.hpp"
+
+namespace abo::error_metrics {
+
+/**
+ * @brief The result of a metric that is computed exactly if possible and estimated otherwise
+ */
+struct GuardedResult
+{
+    //! Whether the value was computed symbolically. If not, it is a sampling estimate
+    bool exact;
+    //! The exact value or the estimate
+    double value;
+    //! The lower end of the confidence interval. Equal to value if the result is exact
+    double lower_bound;
+    //! The upper end of the confidence interval. Equal to value if the result is exact
+    double upper_bound;
+    //! The number of samples that were drawn. Zero if the result is exact
+    long samples;
+};
+
+//! Thrown when a guarded computation hits a limit, see abo::util::ManagerLimits
+using abo::util::ComputationAborted;
+
+/**
+ * @brief Runs an exact computation under resource limits and falls back to an estimate
+ *
+ * For the duration of the exact computation, the manager gets a limit on the number of live nodes
+ * and on its memory, and a termination callback that checks the wall clock time. The error
+ * handlers of the manager are replaced such that a failed operation throws ComputationAborted.
+ * When this happens, all BDDs of the exact computation are released during stack unwinding, the
+ * previous limits and handlers are restored and the estimate is computed instead. The dead nodes
+ * are reclaimed by the next garbage collection.
+ *
+ * The limits are only checked by CUDD, i.e. time spent outside of BDD operations is not
+ * interrupted. Parts of the exact computation that run on a CompiledForest are fast compared to
+ * building the BDDs, though.
+ *
+ * @param mgr The BDD object manager
+ * @param budget The limits for the exact computation. A live node limit below the number of nodes
+ * that are already alive fails the first operation that creates a node
+ * @param exact The exact computation. Must not keep BDDs beyond its return
+ * @param estimate The fallback, which should not build any BDDs
+ * @return The exact value or the estimate with its confidence interval
+ */
+GuardedResult guarded_evaluation(const Cudd& mgr, const abo::util::ComputationBudget& budget,
+                                 const std::function<double()>& exact,
+                                 const std::function<SamplingResult()>& estimate);
+
+/**
+ * @brief Computes the error rate exactly or, if the budget is exceeded, by sequential sampling
+ *
+ * See guarded_evaluation and error_rate_sequential_sampling.
+ *
+ * @param mgr The BDD object manager
+ * @param f The original function
+ * @param f_hat The approximated function. Must have the same number of bits as f
+ * @param budget The limits for the exact computation
+ * @param confidence The confidence of the interval of the estimate
+ * @param half_width The desired half-width of the interval of the estimate
+ * @param seed The seed of the random number generator
+ * @param threads The number of threads to use for sampling. Zero uses all hardware threads
+ * @return The error rate and whether it is exact
+ */
+GuardedResult guarded_error_rate(const Cudd& mgr, const std::vector<BDD>& f,
+                                 const std::vector<BDD>& f_hat,
+                                 const abo::util::ComputationBudget& budget,
+                                 double confidence = 0.99, double half_width = 0.001,
+                                 std::uint64_t seed = 0, unsigned int threads = 1);
+
+/**
+ * @brief Computes the average case error exactly or, if the budget is exceeded, by sampling
+ *
+ * See guarded_evaluation and average_case_error_sequential_sampling.
+ *
+ * @param mgr The BDD object manager
+ * @param f The original function
+ * @param f_hat The approximated function
+ * @param budget The limits for the exact computation
+ * @param confidence The confidence of the interval of the estimate
+ * @param half_width The desired half-width of the interval of the estimate, in the same unit as
+ * the error
+ * @param num_rep The number representation for f and f_hat
+ * @param seed The seed of the random number generator
+ * @param threads The number of threads to use for sampling. Zero uses all hardware threads
+ * @return The average case error and whether it is exact
+ */
+GuardedResult guarded_average_case_error(
+    const Cudd& mgr, const std::vector<BDD>& f, const std::vector<BDD>& f_hat,
+    const abo::util::ComputationBudget& budget, double confidence, double half_width,
+    const abo::util::NumberRepresentation num_rep = abo::util::NumberRepresentation::BaseTwo,
+    std::uint64_t seed = 0, unsigned int threads = 1);
+
+/**
+ * @brief Computes the mean squared error exactly or, if the budget is exceeded, by sampling
+ *
+ * See guarded_evaluation and mean_squared_error_sequential_sampling.
+ *
+ * @param mgr The BDD object manager
+ * @param f The original function
+ * @param f_hat The approximated function
+ * @param budget The limits for the exact computation
+ * @param confidence The confidence of the interval of the estimate
+ * @param half_width The desired half-width of the interval of the estimate, in the same unit as
+ * the error
+ * @param num_rep The number representation for f and f_hat
+ * @param seed The seed of the random number generator
+ * @param threads The number of threads to use for sampling. Zero uses all hardware threads
+ * @return The mean squared error and whether it is exact
+ */
+GuardedResult guarded_mean_squared_error(
+    const Cudd& mgr, const std::vector<BDD>& f, const std::vector<BDD>& f_hat,
+    const abo::util::ComputationBudget& budget, double confidence, double half_width,
+    const abo::util::NumberRepresentation num_rep = abo::util::NumberRepresentation::BaseTwo,
+    std::uint64_t seed = 0, unsigned int threads = 1);
+
+} // namespace abo::error_metrics
@@ -0,0 +1,171 @@
+#include "importance_sampling.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include "bit_parallel_evaluation.hpp"
+#include "compiled_forest.hpp"
+#include "parallel_sampling.hpp"
+#include "random.hpp"
+#include "running_moments.hpp"
+#include "satisfying_input_sampler.hpp"
+
+using abo::util::BitParallelEvaluator;
+using abo::util::CompiledForest;
+using abo::util::NumberRepresentation;
+using abo::util::RunningMoments;
+using Word = BitParallelEvaluator::Word;
+
+namespace abo::error_metrics {
+
+/**
+ * @brief Estimates the mean of |f - f_hat|^exponent
+ *
+ * The inputs are drawn from the mixture of the uniform distributions on the miter bits
+ * D_i = f_i ^ f_hat_i with weights 2^i * P(D_i). The density of an input x then is
+ * w(x) / (W * 2^n) where w(x) is the sum of 2^i over the differing bits and W = sum 2^i P(D_i),
+ * so W * |d(x)|^exponent / w(x) is an unbiased sample of the mean.
+ */
+static SamplingResult importance_sampling(const std::vector<BDD>& f, const std::vector<BDD>& f_hat,
+                                          int exponent, long samples, double confidence,
+                                          NumberRepresentation num_rep, std::uint64_t seed,
+                                          unsigned int threads)
+{
+    assert(f.size() == f_hat.size());
+    if (samples <= 0)
+    {
+        throw std::invalid_argument("At least one sample must be drawn");
+    }
+    constexpr std::size_t block_words = BitParallelEvaluator::words_per_block;
+    const std::size_t bits = f.size();
+    const std::size_t difference_bits = bits + 1;
+
+    std::vector<BDD> forest = f;
+    forest.insert(forest.end(), f_hat.begin(), f_hat.end());
+    for (std::size_t i = 0; i < bits; i++)
+    {
+        forest.push_back(f[i] ^ f_hat[i]);
+    }
+    const CompiledForest compiled(forest);
+    const std::vector<double> fractions = compiled.minterm_fractions();
+    // one table of thresholds serves the samplers of all miter bits
+    const abo::util::SamplingThresholds thresholds(compiled, fractions);
+
+    std::vector<double> component_weight(bits);
+    std::vector<abo::util::SatisfyingInputSampler> samplers;
+    samplers.reserve(bits);
+    double total_weight = 0;
+    std::size_t last_component = 0;
+    for (std::size_t i = 0; i < bits; i++)
+    {
+        const double probability =
+            CompiledForest::edge_fraction(fractions, compiled.root(2 * bits + i));
+        component_weight[i] = std::ldexp(probability, static_cast<int>(i));
+        total_weight += component_weight[i];
+        if (component_weight[i] > 0)
+        {
+            last_component = i;
+        }
+        samplers.emplace_back(thresholds, 2 * bits + i);
+    }
+
+    // f and f_hat are equal
+    if (total_weight == 0)
+    {
+        return {0, 0, 0, 0, samples};
+    }
+
+    const std::size_t num_chunks = abo::util::sample_chunk_count(samples);
+    std::vector<RunningMoments> chunk_moments(num_chunks);
+    abo::util::parallel_chunks(num_chunks, threads, [&]() {
+        return [&, evaluator = BitParallelEvaluator(compiled),
+                inputs = std::vector<Word>(compiled.num_inputs() * block_words),
+                outputs = std::vector<Word>(forest.size() * block_words),
+                difference = std::vector<Word>(difference_bits * block_words)](
+                   std::size_t chunk) mutable {
+            abo::util::Xoshiro256StarStar generator(seed, chunk);
+            RunningMoments moments;
+
+            // the samples of the chunk are split among the components with a multinomial
+            // distribution, which gives the same distribution as drawing each sample from the
+            // mixture individually
+            std::size_t remaining = abo::util::samples_in_chunk(samples, chunk);
+            double remaining_weight = total_weight;
+            for (std::size_t i = 0; i <= last_component && remaining > 0; i++)
+            {
+                std::size_t component_samples = remaining;
+                if (component_weight[i] == 0)
+                {
+                    continue;
+                }
+                if (i < last_component)
+                {
+                    const double p = std::min(1.0, component_weight[i] / remaining_weight);
+                    component_samples =
+                        std::binomial_distribution<std::size_t>(remaining, p)(generator);
+                }
+                remaining -= component_samples;
+                remaining_weight -= component_weight[i];
+
+                for (std::size_t block_start = 0; block_start < component_samples;
+                     block_start += BitParallelEvaluator::block_size)
+                {
+                    const std::size_t block_samples =
+                        std::min(BitParallelEvaluator::block_size, component_samples - block_start);
+                    samplers[i].sample(generator, block_samples, compiled.num_inputs(),
+                                       inputs.data());
+                    evaluator.evaluate(inputs.data(), outputs.data());
+                    abo::util::block_absolute_difference(outputs.data(), bits,
+                                                         outputs.data() + bits * block_words, bits,
+                                                         num_rep, difference.data());
+
+                    const Word* miter = outputs.data() + 2 * bits * block_words;
+                    for (std::size_t lane = 0; lane < block_samples; lane++)
+                    {
+                        const double weight = abo::util::block_value(miter, bits, lane);
+                        const double value =
+                            abo::util::block_value(difference.data(), difference_bits, lane);
+                        moments.add(std::pow(value, exponent) / weight);
+                    }
+                }
+            }
+            chunk_moments[chunk] = moments;
+        };
+    });
+
+    RunningMoments total;
+    for (const RunningMoments& m : chunk_moments)
+    {
+        total.merge(m);
+    }
+
+    // |d| <= w, so the weighted absolute differences lie in [0, 1] and the weighted squared
+    // differences in [0, max |d|]
+    const double range = exponent == 1 ? 1.0 : std::ldexp(1.0, static_cast<int>(bits));
+    const double deviation =
+        abo::util::empirical_bernstein_deviation(total, range, 1 - confidence);
+    return {total_weight * total.mean, total_weight * std::max(0.0, total.mean - deviation),
+            total_weight * std::min(range, total.mean + deviation),
+            total_weight * total_weight * total.variance() / total.count, total.count};
+}
+
+SamplingResult average_case_error_importance_sampling(
+    [[maybe_unused]] const Cudd& mgr, const std::vector<BDD>& f, const std::vector<BDD>& f_hat,
+    long samples, double confidence, const NumberRepresentation num_rep, std::uint64_t seed,
+    unsigned int threads)
+{
+    return importance_sampling(f, f_hat, 1, samples, confidence, num_rep, seed, threads);
+}
+
+SamplingResult mean_squared_error_importance_sampling(
+    [[maybe_unused]] const Cudd& mgr, const std::vector<BDD>& f, const std::vector<BDD>& f_hat,
+    long samples, double confidence, const NumberRepresentation num_rep, std::uint64_t seed,
+    unsigned int threads)
+{
+    return importance_sampling(f, f_hat, 2, samples, confidence, num_rep, seed, threads);
+}
+
+} // namespace abo::error_metrics
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <cudd/cplusplus/cuddObj.hh>
+#include <vector>
+
+#include "number_representation.hpp"
+#include "sequential_sampling.hpp"
+
+namespace abo::error_metrics {
+
+/**
+ * @brief Estimates the average case error with importance sampling on the miter
+ *
+ * Only the BDDs f[i] ^ f_hat[i] are built, the subtraction is performed on the concrete samples.
+ * The inputs are drawn with a probability proportional to w(x) = sum of 2^i over all bits i in
+ * which f(x) and f_hat(x) differ, so inputs without any error are never drawn and inputs with
+ * errors in significant bits are drawn more often. As |f(x) - f_hat(x)| <= w(x), the weighted
+ * samples are bounded, which keeps the variance low even if errors are very rare.
+ *
+ * The estimate is unbiased. The interval is an empirical Bernstein bound that holds with the given
+ * confidence.
+ *
+ * @param mgr The BDD object manager
+ * @param f The original function
+ * @param f_hat The approximated function. Must have the same number of bits as f
+ * @param samples The number of samples to draw. Must be positive
+ * @param confidence The probability with which the error lies within the returned interval
+ * @param num_rep The number representation for f and f_hat
+ * @param seed The seed of the random number generator
+ * @param threads The number of threads to use. Zero uses all hardware threads. The result does not
+ * depend on the number of threads
+ * @return The estimated average case error with its variance and confidence interval
+ */
+SamplingResult average_case_error_importance_sampling(
+    const Cudd& mgr, const std::vector<BDD>& f, const std::vector<BDD>& f_hat,
+    long samples = 100000, double confidence = 0.99,
+    const abo::util::NumberRepresentation num_rep = abo::util::NumberRepresentation::BaseTwo,
+    std::uint64_t seed = 0, unsigned int threads = 1);
+
+/**
+ * @brief Estimates the mean squared error with importance sampling on the miter
+ *
+ * See average_case_error_importance_sampling, the sampled values are (f - f_hat)^2.
+ *
+ * @param mgr The BDD object manager
+ * @param f The original function
+ * @param f_hat The approximated function. Must have the same number of bits as f
+ * @param samples The number of samples to draw. Must be positive
+ * @param confidence The probability with which the error lies within the returned interval
+ * @param num_rep The number representation for f and f_hat
+ * @param seed The seed of the random number generator
+ * @param threads The number of threads to use. Zero uses all hardware threads
+ * @return The estimated mean squared error with its variance and confidence interval
+ */
+SamplingResult mean_squared_error_importance_sampling(
+    const Cudd& mgr, const std::vector<BDD>& f, const std::vector<BDD>& f_hat,
+    long samples = 100000, double confidence = 0.99,
+    const abo::util::NumberRepresentation num_rep = abo::util::NumberRepresentation::BaseTwo,
+    std::uint64_t seed = 0, unsigned int threads = 1);
+
+} // namespace abo::error_metrics
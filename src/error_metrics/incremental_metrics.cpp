@@ -0,0 +1,139 @@
+#include "incremental_metrics.hpp"
+
+#include <cassert>
+#include <numeric>
+
+#include "compiled_forest.hpp"
+#include "cudd_helpers.hpp"
+
+using boost::multiprecision::cpp_int;
+using boost::multiprecision::cpp_rational;
+
+namespace abo::error_metrics {
+
+IncrementalMetrics::IncrementalMetrics(const Cudd& mgr, const std::vector<BDD>& f,
+                                       const std::vector<BDD>& f_hat)
+    : mgr(mgr), f(f), f_hat(f_hat)
+{
+    assert(f.size() == f_hat.size());
+}
+
+cpp_int IncrementalMetrics::count(const BDD& bdd) const
+{
+    return abo::util::CompiledForest({bdd}).output_minterm_counts().front();
+}
+
+double IncrementalMetrics::fraction(const cpp_int& count) const
+{
+    // the counts of a CompiledForest are over all variables of the manager
+    return static_cast<double>(cpp_rational(count, cpp_int(1) << mgr.ReadSize()));
+}
+
+const std::vector<BDD>& IncrementalMetrics::miters()
+{
+    if (!cached_miters)
+    {
+        std::vector<BDD> result;
+        result.reserve(f.size());
+        for (std::size_t i = 0; i < f.size(); i++)
+        {
+            result.push_back(f[i] ^ f_hat[i]);
+        }
+        cached_miters = std::move(result);
+    }
+    return *cached_miters;
+}
+
+const BDD& IncrementalMetrics::miter(std::size_t output)
+{
+    return miters()[output];
+}
+
+const std::vector<cpp_int>& IncrementalMetrics::miter_counts()
+{
+    if (!cached_miter_counts)
+    {
+        // one pass over the shared nodes of all miters
+        cached_miter_counts = abo::util::CompiledForest(miters()).output_minterm_counts();
+    }
+    return *cached_miter_counts;
+}
+
+const std::vector<BDD>& IncrementalMetrics::other_errors()
+{
+    if (!cached_other_errors)
+    {
+        const std::vector<BDD>& m = miters();
+
+        // prefix disjunctions first, then the suffix is added while walking backwards
+        std::vector<BDD> result(m.size(), mgr.bddZero());
+        for (std::size_t i = 1; i < m.size(); i++)
+        {
+            result[i] = result[i - 1] | m[i - 1];
+        }
+        BDD suffix = mgr.bddZero();
+        for (std::size_t i = m.size(); i-- > 0;)
+        {
+            result[i] |= suffix;
+            suffix |= m[i];
+        }
+        cached_other_errors = std::move(result);
+    }
+    return *cached_other_errors;
+}
+
+const ADD& IncrementalMetrics::bit_flip_sum()
+{
+    if (!cached_bit_flip_sum)
+    {
+        ADD sum = mgr.addZero();
+        for (const BDD& m : miters())
+        {
+            sum += m.Add();
+        }
+        cached_bit_flip_sum = sum;
+    }
+    return *cached_bit_flip_sum;
+}
+
+double IncrementalMetrics::error_rate()
+{
+    if (f.empty())
+    {
+        return 0;
+    }
+    return fraction(count(other_errors()[0] | miter(0)));
+}
+
+double IncrementalMetrics::average_bit_flip_error()
+{
+    return fraction(std::accumulate(miter_counts().begin(), miter_counts().end(), cpp_int(0)));
+}
+
+unsigned int IncrementalMetrics::worst_case_bit_flip_error()
+{
+    return abo::util::const_ADD_value(bit_flip_sum().FindMax());
+}
+
+double IncrementalMetrics::error_rate(std::size_t output, const BDD& replacement)
+{
+    return fraction(count(other_errors()[output] | (f[output] ^ replacement)));
+}
+
+double IncrementalMetrics::average_bit_flip_error(std::size_t output, const BDD& replacement)
+{
+    // the counts are exact, so exchanging the one of the output gives the sum of the candidate
+    const std::vector<cpp_int>& counts = miter_counts();
+    const cpp_int sum = std::accumulate(counts.begin(), counts.end(), cpp_int(0)) -
+                        counts[output] + count(f[output] ^ replacement);
+    return fraction(sum);
+}
+
+unsigned int IncrementalMetrics::worst_case_bit_flip_error(std::size_t output,
+                                                           const BDD& replacement)
+{
+    const ADD sum = bit_flip_sum() - miter(output).Add() + (f[output] ^ replacement).Add();
+    return abo::util::const_ADD_value(sum.FindMax());
+}
+
+} // namespace abo::error_metrics
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cudd/cplusplus/cuddObj.hh>
+#include <optional>
+#include <vector>
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+namespace abo::error_metrics {
+
+/**
+ * @brief Computes the bit-wise error metrics of an approximation and of variants of it that differ
+ * in a single output
+ *
+ * The error rate and the average and worst case bit flip errors are compositions of per-output
+ * quantities: the miters f[i] ^ f_hat[i], the number of inputs for which each of them is one and
+ * their sum as an ADD. These are computed on first use for f_hat. The metrics of a candidate that
+ * only replaces f_hat[i] are then computed by exchanging the contribution of output i, instead of
+ * recomputing all outputs. For the error rate, the disjunction of the miters of all other outputs
+ * is kept for every output.
+ *
+ * The inputs are counted exactly with a CompiledForest like in error_rate and
+ * average_bit_flip_error, so the results are the same as those of error_rate,
+ * average_bit_flip_error and worst_case_bit_flip_error for any number of inputs.
+ */
+class IncrementalMetrics
+{
+public:
+    /**
+     * @brief Creates the partial results for the given functions. Nothing is computed until it is
+     * needed
+     * @param mgr The BDD object manager
+     * @param f The original function
+     * @param f_hat The approximated function that candidates are derived from. Must have the same
+     * number of bits as f
+     */
+    IncrementalMetrics(const Cudd& mgr, const std::vector<BDD>& f, const std::vector<BDD>& f_hat);
+
+    //! Returns the miter f[output] ^ f_hat[output]
+    const BDD& miter(std::size_t output);
+
+    //! Returns the error rate of f_hat
+    double error_rate();
+
+    //! Returns the average bit flip error of f_hat
+    double average_bit_flip_error();
+
+    //! Returns the worst case bit flip error of f_hat
+    unsigned int worst_case_bit_flip_error();
+
+    /**
+     * @brief Computes the error rate of f_hat with one output replaced
+     * @param output The index of the replaced output
+     * @param replacement The new function of that output
+     * @return The error rate of the candidate
+     */
+    double error_rate(std::size_t output, const BDD& replacement);
+
+    /**
+     * @brief Computes the average bit flip error of f_hat with one output replaced
+     * @param output The index of the replaced output
+     * @param replacement The new function of that output
+     * @return The average bit flip error of the candidate
+     */
+    double average_bit_flip_error(std::size_t output, const BDD& replacement);
+
+    /**
+     * @brief Computes the worst case bit flip error of f_hat with one output replaced
+     * @param output The index of the replaced output
+     * @param replacement The new function of that output
+     * @return The worst case bit flip error of the candidate
+     */
+    unsigned int worst_case_bit_flip_error(std::size_t output, const BDD& replacement);
+
+private:
+    //! Returns the exact number of inputs for which bdd is one
+    boost::multiprecision::cpp_int count(const BDD& bdd) const;
+
+    //! Returns the fraction of all inputs that count stands for
+    double fraction(const boost::multiprecision::cpp_int& count) const;
+
+    const std::vector<BDD>& miters();
+    const std::vector<boost::multiprecision::cpp_int>& miter_counts();
+    const std::vector<BDD>& other_errors();
+    const ADD& bit_flip_sum();
+
+    Cudd mgr;
+    std::vector<BDD> f;
+    std::vector<BDD> f_hat;
+
+    std::optional<std::vector<BDD>> cached_miters;
+    //! the number of inputs for which each miter is one
+    std::optional<std::vector<boost::multiprecision::cpp_int>> cached_miter_counts;
+    //! for every output, the disjunction of the miters of all other outputs
+    std::optional<std::vector<BDD>> cached_other_errors;
+    std::optional<ADD> cached_bit_flip_sum;
+};
+
+} // namespace abo::error_metrics
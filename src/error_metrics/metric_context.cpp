@@ -0,0 +1,243 @@
+#include "metric_context.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include "cudd_helpers.hpp"
+#include "incremental_metrics.hpp"
+
+using abo::util::NumberRepresentation;
+
+namespace abo::error_metrics {
+
+PreparedOriginal::PreparedOriginal(const Cudd& mgr, const std::vector<BDD>& f,
+                                   const NumberRepresentation num_rep)
+    : mgr(mgr), f(f), num_rep(num_rep), table(std::make_shared<abo::util::ExactValueTable>())
+{
+}
+
+const ADD& PreparedOriginal::add()
+{
+    if (!cached_add)
+    {
+        cached_add = abo::util::bdd_forest_to_add(mgr, f, num_rep);
+    }
+    return *cached_add;
+}
+
+const std::vector<BDD>& PreparedOriginal::absolute()
+{
+    if (!cached_absolute)
+    {
+        cached_absolute = abo::util::bdd_abs(mgr, f, num_rep);
+    }
+    return *cached_absolute;
+}
+
+const std::vector<BDD>& PreparedOriginal::absolute_max_one()
+{
+    if (!cached_absolute_max_one)
+    {
+        cached_absolute_max_one = abo::util::bdd_max_one(mgr, absolute());
+    }
+    return *cached_absolute_max_one;
+}
+
+const ADD& PreparedOriginal::absolute_add()
+{
+    if (!cached_absolute_add)
+    {
+        cached_absolute_add = abo::util::bdd_forest_to_add(mgr, absolute());
+    }
+    return *cached_absolute_add;
+}
+
+const ADD& PreparedOriginal::absolute_max_one_add()
+{
+    if (!cached_absolute_max_one_add)
+    {
+        cached_absolute_max_one_add = absolute_add().Maximum(mgr.addOne());
+    }
+    return *cached_absolute_max_one_add;
+}
+
+const abo::util::ExactAdd& PreparedOriginal::exact_add()
+{
+    if (!cached_exact_add)
+    {
+        cached_exact_add = abo::util::bdd_forest_to_exact_add(mgr, f, table, num_rep);
+    }
+    return *cached_exact_add;
+}
+
+const abo::util::ExactAdd& PreparedOriginal::exact_absolute_max_one_add()
+{
+    if (!cached_exact_absolute_max_one_add)
+    {
+        using boost::multiprecision::cpp_rational;
+        cached_exact_absolute_max_one_add = abo::util::exact_add_apply(
+            mgr, exact_add(), abo::util::exact_add_constant(mgr, 1, table),
+            [](const cpp_rational& value, const cpp_rational& one) {
+                return std::max(cpp_rational(abs(value)), one);
+            });
+    }
+    return *cached_exact_absolute_max_one_add;
+}
+
+MetricContext::MetricContext(const Cudd& mgr, const std::vector<BDD>& f,
+                             const std::vector<BDD>& f_hat, const NumberRepresentation num_rep)
+    : MetricContext(std::make_shared<PreparedOriginal>(mgr, f, num_rep), f_hat)
+{
+}
+
+MetricContext::MetricContext(std::shared_ptr<PreparedOriginal> original,
+                             const std::vector<BDD>& f_hat)
+    : prepared(std::move(original)), f_hat(f_hat),
+      table(std::make_shared<abo::util::ExactValueTable>())
+{
+}
+
+void MetricContext::set_single_output_change(std::shared_ptr<IncrementalMetrics> base,
+                                             std::size_t output)
+{
+    incremental_base = std::move(base);
+    changed = output;
+}
+
+void MetricContext::set_batch_selection(std::shared_ptr<MetricContext> batch_context,
+                                        const BDD& batch_selection)
+{
+    batch = std::move(batch_context);
+    selection = batch_selection;
+}
+
+//! Returns the cofactors of all functions of the forest with respect to the cube
+static std::vector<BDD> cofactor_forest(const std::vector<BDD>& forest, const BDD& cube)
+{
+    std::vector<BDD> result;
+    result.reserve(forest.size());
+    for (const BDD& b : forest)
+    {
+        result.push_back(b.Cofactor(cube));
+    }
+    return result;
+}
+
+const std::vector<BDD>& MetricContext::miter()
+{
+    if (!cached_miter && batch)
+    {
+        cached_miter = cofactor_forest(batch->miter(), *selection);
+    }
+    if (!cached_miter)
+    {
+        const std::vector<BDD>& f = original();
+        assert(f.size() == f_hat.size());
+        std::vector<BDD> result;
+        result.reserve(f.size());
+        for (std::size_t i = 0; i < f.size(); i++)
+        {
+            const bool unchanged = incremental_base && i != changed;
+            result.push_back(unchanged ? incremental_base->miter(i) : f[i] ^ f_hat[i]);
+        }
+        cached_miter = std::move(result);
+    }
+    return *cached_miter;
+}
+
+const std::vector<BDD>& MetricContext::difference()
+{
+    if (!cached_difference && batch)
+    {
+        cached_difference = cofactor_forest(batch->difference(), *selection);
+    }
+    if (!cached_difference)
+    {
+        cached_difference =
+            abo::util::bdd_difference(manager(), original(), f_hat, number_representation());
+    }
+    return *cached_difference;
+}
+
+const std::vector<BDD>& MetricContext::absolute_difference()
+{
+    if (!cached_absolute_difference && batch)
+    {
+        cached_absolute_difference = cofactor_forest(batch->absolute_difference(), *selection);
+    }
+    if (!cached_absolute_difference)
+    {
+        cached_absolute_difference = abo::util::bdd_absolute_difference(
+            manager(), original(), f_hat, number_representation());
+    }
+    return *cached_absolute_difference;
+}
+
+const ADD& MetricContext::absolute_difference_add()
+{
+    if (!cached_absolute_difference_add && batch)
+    {
+        cached_absolute_difference_add =
+            batch->absolute_difference_add().Cofactor(selection->Add());
+    }
+    if (!cached_absolute_difference_add)
+    {
+        // built in one descent over both forests, which avoids the ADD of f_hat
+        cached_absolute_difference_add = abo::util::absolute_difference_add(
+            manager(), original(), f_hat, number_representation());
+    }
+    return *cached_absolute_difference_add;
+}
+
+const ADD& MetricContext::relative_difference_add()
+{
+    if (!cached_relative_difference_add)
+    {
+        cached_relative_difference_add =
+            absolute_difference_add().Divide(prepared->absolute_max_one_add());
+    }
+    return *cached_relative_difference_add;
+}
+
+const ADD& MetricContext::xor_difference_add()
+{
+    if (!cached_xor_difference_add && batch)
+    {
+        cached_xor_difference_add = batch->xor_difference_add().Cofactor(selection->Add());
+    }
+    if (!cached_xor_difference_add)
+    {
+        cached_xor_difference_add = abo::util::xor_difference_add(manager(), original(), f_hat);
+    }
+    return *cached_xor_difference_add;
+}
+
+const abo::util::ExactAdd& MetricContext::exact_absolute_difference_add()
+{
+    if (!cached_exact_absolute_difference_add)
+    {
+        // the values of f_hat and the differences only belong to this candidate, so they are not
+        // added to the table of the original, which is shared by all candidates
+        const abo::util::ExactAdd f_add =
+            abo::util::exact_add_reindex(manager(), prepared->exact_add(), table);
+        const abo::util::ExactAdd f_hat_add =
+            abo::util::bdd_forest_to_exact_add(manager(), f_hat, table, number_representation());
+        cached_exact_absolute_difference_add =
+            abo::util::exact_absolute_difference_add(manager(), f_add, f_hat_add);
+    }
+    return *cached_exact_absolute_difference_add;
+}
+
+const abo::util::ExactAdd& MetricContext::exact_relative_difference_add()
+{
+    if (!cached_exact_relative_difference_add)
+    {
+        const abo::util::ExactAdd divisor =
+            abo::util::exact_add_reindex(manager(), prepared->exact_absolute_max_one_add(), table);
+        cached_exact_relative_difference_add =
+            abo::util::exact_add_divide(manager(), exact_absolute_difference_add(), divisor);
+    }
+    return *cached_exact_relative_difference_add;
+}
+
+} // namespace abo::error_metrics
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <cudd/cplusplus/cuddObj.hh>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "exact_add.hpp"
+#include "number_representation.hpp"
+
+namespace abo::error_metrics {
+
+class IncrementalMetrics;
+
+/**
+ * @brief Holds an original function together with the structures the error metrics derive from
+ * the original function alone
+ *
+ * Minimization algorithms compare one fixed original function against many candidate
+ * approximations. Everything that does not depend on the candidate, such as |f|, max(1, |f|) and
+ * their ADDs, is computed on first use and then shared by all candidates through the MetricContext
+ * objects created from this instance.
+ */
+class PreparedOriginal
+{
+public:
+    /**
+     * @brief Prepares the given function. Nothing is computed until it is needed
+     * @param mgr The BDD object manager
+     * @param f The original function
+     * @param num_rep The number representation for f and the approximations compared to it
+     */
+    PreparedOriginal(const Cudd& mgr, const std::vector<BDD>& f,
+                     const abo::util::NumberRepresentation num_rep =
+                         abo::util::NumberRepresentation::BaseTwo);
+
+    //! Returns the BDD object manager
+    const Cudd& manager() const
+    {
+        return mgr;
+    }
+
+    //! Returns the original function f
+    const std::vector<BDD>& function() const
+    {
+        return f;
+    }
+
+    //! Returns the number representation of f
+    abo::util::NumberRepresentation number_representation() const
+    {
+        return num_rep;
+    }
+
+    //! Returns f as an ADD
+    const ADD& add();
+
+    //! Returns the BDD forest of |f|
+    const std::vector<BDD>& absolute();
+
+    //! Returns the BDD forest of max(1, |f|)
+    const std::vector<BDD>& absolute_max_one();
+
+    //! Returns |f| as an ADD
+    const ADD& absolute_add();
+
+    //! Returns max(1, |f|) as an ADD, i.e. the divisor of the relative error metrics
+    const ADD& absolute_max_one_add();
+
+    //! Returns the table of the values of the ExactAdds of f. The ExactAdds of the approximations
+    //! use the table of their MetricContext, so this one does not grow with the candidates
+    const std::shared_ptr<abo::util::ExactValueTable>& exact_table()
+    {
+        return table;
+    }
+
+    //! Returns f as an ExactAdd
+    const abo::util::ExactAdd& exact_add();
+
+    //! Returns max(1, |f|) as an ExactAdd
+    const abo::util::ExactAdd& exact_absolute_max_one_add();
+
+private:
+    Cudd mgr;
+    std::vector<BDD> f;
+    abo::util::NumberRepresentation num_rep;
+
+    std::optional<ADD> cached_add;
+    std::optional<std::vector<BDD>> cached_absolute;
+    std::optional<std::vector<BDD>> cached_absolute_max_one;
+    std::optional<ADD> cached_absolute_add;
+    std::optional<ADD> cached_absolute_max_one_add;
+    std::shared_ptr<abo::util::ExactValueTable> table;
+    std::optional<abo::util::ExactAdd> cached_exact_add;
+    std::optional<abo::util::ExactAdd> cached_exact_absolute_max_one_add;
+};
+
+/**
+ * @brief Holds a pair of an original and an approximated function together with the intermediate
+ * results that the error metrics compute from them
+ *
+ * Most metrics start by building the same expensive structures, most notably the absolute
+ * difference |f - f_hat| as a BDD forest or as an ADD. The context computes each of them on first
+ * use and keeps it, so evaluating several metrics for the same pair of functions builds the
+ * subtractor only once. The results that only depend on f are kept in a PreparedOriginal, which can
+ * be shared by the contexts of many approximations. A context must not be shared between threads.
+ */
+class MetricContext
+{
+public:
+    /**
+     * @brief Creates a context for the given functions. Nothing is computed until it is needed
+     * @param mgr The BDD object manager
+     * @param f The original function
+     * @param f_hat The approximated function. Must have the same number of bits as f
+     * @param num_rep The number representation for f and f_hat
+     */
+    MetricContext(const Cudd& mgr, const std::vector<BDD>& f, const std::vector<BDD>& f_hat,
+                  const abo::util::NumberRepresentation num_rep =
+                      abo::util::NumberRepresentation::BaseTwo);
+
+    /**
+     * @brief Creates a context for an approximation of an already prepared original function
+     * @param original The original function. Its number representation is used for f_hat as well
+     * @param f_hat The approximated function. Must have the same number of bits as f
+     */
+    MetricContext(std::shared_ptr<PreparedOriginal> original, const std::vector<BDD>& f_hat);
+
+    //! Returns the BDD object manager
+    const Cudd& manager() const
+    {
+        return prepared->manager();
+    }
+
+    //! Returns the original function f
+    const std::vector<BDD>& original() const
+    {
+        return prepared->function();
+    }
+
+    //! Returns the approximated function f_hat
+    const std::vector<BDD>& approximation() const
+    {
+        return f_hat;
+    }
+
+    //! Returns the number representation of f and f_hat
+    abo::util::NumberRepresentation number_representation() const
+    {
+        return prepared->number_representation();
+    }
+
+    //! Returns the structures derived from the original function alone
+    PreparedOriginal& prepared_original()
+    {
+        return *prepared;
+    }
+
+    /**
+     * @brief Declares that f_hat differs from the approximation of base in the given output only.
+     * The bit-wise metrics then only update the contribution of this output
+     * @param base The partial results of the approximation f_hat was derived from. Must have been
+     * created for the same original function
+     * @param output The index of the only output in which f_hat differs
+     */
+    void set_single_output_change(std::shared_ptr<IncrementalMetrics> base, std::size_t output);
+
+    //! Returns the base set by set_single_output_change or nullptr if there is none
+    IncrementalMetrics* single_output_base() const
+    {
+        return incremental_base.get();
+    }
+
+    //! Returns the output given to set_single_output_change
+    std::size_t changed_output() const
+    {
+        return changed;
+    }
+
+    /**
+     * @brief Declares that f_hat is the cofactor of the approximation of batch with respect to
+     * selection. The forests and ADDs of the differences are then taken as cofactors of the ones of
+     * batch, so candidates that share most of their structure share the work as well
+     * @param batch The context of a multiplexed approximation, see evaluate_candidates. Must have
+     * been created for the same original function
+     * @param selection A cube over variables that neither f nor f_hat depend on
+     */
+    void set_batch_selection(std::shared_ptr<MetricContext> batch, const BDD& selection);
+
+    //! Returns the bit-wise miter f[i] ^ f_hat[i]
+    const std::vector<BDD>& miter();
+
+    //! Returns the BDD forest of f - f_hat in Two's Complement
+    const std::vector<BDD>& difference();
+
+    //! Returns the BDD forest of |f - f_hat|
+    const std::vector<BDD>& absolute_difference();
+
+    //! Returns the BDD forest of |f|
+    const std::vector<BDD>& original_absolute()
+    {
+        return prepared->absolute();
+    }
+
+    //! Returns the BDD forest of max(1, |f|)
+    const std::vector<BDD>& original_absolute_max_one()
+    {
+        return prepared->absolute_max_one();
+    }
+
+    //! Returns |f - f_hat| as an ADD
+    const ADD& absolute_difference_add();
+
+    //! Returns |f| as an ADD
+    const ADD& original_absolute_add()
+    {
+        return prepared->absolute_add();
+    }
+
+    //! Returns |f - f_hat| / max(1, |f|) as an ADD
+    const ADD& relative_difference_add();
+
+    //! Returns the bit-wise XOR of f and f_hat as an ADD with unsigned integer values
+    const ADD& xor_difference_add();
+
+    //! Returns whether the values of |f - f_hat| can exceed 2^53, above which the double terminals
+    //! of an ADD do not represent all integers. The ADD based metrics then use ExactAdds instead
+    bool needs_exact_terminals() const
+    {
+        return original().size() > 53;
+    }
+
+    //! Returns |f - f_hat| as an ExactAdd. Its values are stored in a table of this context, which
+    //! is released together with it
+    const abo::util::ExactAdd& exact_absolute_difference_add();
+
+    //! Returns |f - f_hat| / max(1, |f|) as an ExactAdd
+    const abo::util::ExactAdd& exact_relative_difference_add();
+
+private:
+    std::shared_ptr<PreparedOriginal> prepared;
+    std::vector<BDD> f_hat;
+    std::shared_ptr<IncrementalMetrics> incremental_base;
+    std::size_t changed = 0;
+    std::shared_ptr<MetricContext> batch;
+    std::optional<BDD> selection;
+
+    std::optional<std::vector<BDD>> cached_miter;
+    std::optional<std::vector<BDD>> cached_difference;
+    std::optional<std::vector<BDD>> cached_absolute_difference;
+    std::optional<ADD> cached_absolute_difference_add;
+    std::optional<ADD> cached_relative_difference_add;
+    std::optional<ADD> cached_xor_difference_add;
+    std::shared_ptr<abo::util::ExactValueTable> table;
+    std::optional<abo::util::ExactAdd> cached_exact_absolute_difference_add;
+    std::optional<abo::util::ExactAdd> cached_exact_relative_difference_add;
+};
+
+} // namespace abo::error_metrics
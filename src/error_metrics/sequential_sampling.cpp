@@ -0,0 +1,222 @@
+#include "sequential_sampling.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+
+#include <boost/math/special_functions/beta.hpp>
+
+#include "bit_parallel_evaluation.hpp"
+#include "compiled_forest.hpp"
+#include "parallel_sampling.hpp"
+#include "random.hpp"
+#include "running_moments.hpp"
+
+using abo::util::BitParallelEvaluator;
+using abo::util::NumberRepresentation;
+using abo::util::RunningMoments;
+using Word = BitParallelEvaluator::Word;
+
+namespace abo::error_metrics {
+
+//! Returns the lower and upper end of a confidence interval for the given moments
+using IntervalFunction =
+    std::function<std::pair<double, double>(const RunningMoments&, double delta)>;
+
+//! Computes the moments of the samples of one chunk
+using ChunkFunction = std::function<RunningMoments(std::size_t chunk, std::size_t samples)>;
+
+/**
+ * @brief Draws chunks of samples in rounds of doubling size until the interval is narrow enough
+ * @param make_worker Called once per thread, returns the function that evaluates one chunk
+ */
+static SamplingResult sample_until(const std::function<ChunkFunction()>& make_worker,
+                                   const IntervalFunction& interval, double confidence,
+                                   double half_width, long max_samples, unsigned int threads)
+{
+    if (max_samples <= 0)
+    {
+        throw std::invalid_argument("At least one sample must be drawn");
+    }
+    const std::size_t max_chunks = abo::util::sample_chunk_count(max_samples);
+
+    RunningMoments total;
+    std::pair<double, double> bounds{0, 0};
+    std::size_t processed = 0;
+    for (std::size_t round = 0; processed < max_chunks; round++)
+    {
+        const std::size_t next = std::min(max_chunks, std::max<std::size_t>(1, 2 * processed));
+        std::vector<RunningMoments> chunk_moments(next - processed);
+        abo::util::parallel_chunks(next - processed, threads, [&]() {
+            return [&, evaluate_chunk = make_worker()](std::size_t c) {
+                chunk_moments[c] = evaluate_chunk(
+                    processed + c, abo::util::samples_in_chunk(max_samples, processed + c));
+            };
+        });
+        for (const RunningMoments& m : chunk_moments)
+        {
+            total.merge(m);
+        }
+        processed = next;
+
+        // check i is made with confidence 1 - delta / ((i + 1)(i + 2)), these sum up to delta
+        const double delta = (1 - confidence) / ((round + 1.0) * (round + 2.0));
+        bounds = interval(total, delta);
+        if ((bounds.second - bounds.first) / 2 <= half_width)
+        {
+            break;
+        }
+    }
+
+    return {total.mean, bounds.first, bounds.second,
+            total.count > 0 ? total.variance() / total.count : 0, total.count};
+}
+
+static std::pair<double, double> clopper_pearson(const RunningMoments& moments, double delta)
+{
+    const double n = static_cast<double>(moments.count);
+    const double k = std::round(moments.mean * n);
+    const double lower = k == 0 ? 0.0 : boost::math::ibeta_inv(k, n - k + 1, delta / 2);
+    const double upper = k == n ? 1.0 : boost::math::ibeta_inv(k + 1, n - k, 1 - delta / 2);
+    return {lower, upper};
+}
+
+//! Returns the empirical Bernstein interval for samples in [0, range]
+static IntervalFunction empirical_bernstein(double range)
+{
+    return [range](const RunningMoments& moments, double delta) -> std::pair<double, double> {
+        const double deviation = abo::util::empirical_bernstein_deviation(moments, range, delta);
+        return {std::max(0.0, moments.mean - deviation), std::min(range, moments.mean + deviation)};
+    };
+}
+
+//! Samples |f - f_hat|^exponent for uniformly distributed inputs
+static SamplingResult sample_difference(const std::vector<BDD>& f,
+                                        const std::vector<BDD>& f_hat, int exponent,
+                                        double confidence, double half_width, long max_samples,
+                                        double value_range, NumberRepresentation num_rep,
+                                        std::uint64_t seed, unsigned int threads)
+{
+    constexpr std::size_t block_words = BitParallelEvaluator::words_per_block;
+
+    std::vector<BDD> forest = f;
+    forest.insert(forest.end(), f_hat.begin(), f_hat.end());
+    const abo::util::CompiledForest compiled(forest);
+    const std::size_t difference_bits = std::max(f.size(), f_hat.size()) + 1;
+
+    if (value_range <= 0)
+    {
+        value_range = std::ldexp(1.0, static_cast<int>(difference_bits) - 1);
+    }
+    const double sample_range = std::pow(value_range, exponent);
+
+    auto make_worker = [&]() -> ChunkFunction {
+        return [&, evaluator = BitParallelEvaluator(compiled)](std::size_t chunk,
+                                                               std::size_t samples) mutable {
+            std::vector<Word> inputs(compiled.num_inputs() * block_words);
+            std::vector<Word> outputs(forest.size() * block_words);
+            std::vector<Word> difference(difference_bits * block_words);
+            abo::util::Xoshiro256StarStar generator(seed, chunk);
+
+            RunningMoments moments;
+            for (std::size_t block_start = 0; block_start < samples;
+                 block_start += BitParallelEvaluator::block_size)
+            {
+                std::generate(inputs.begin(), inputs.end(), std::ref(generator));
+                evaluator.evaluate(inputs.data(), outputs.data());
+                abo::util::block_absolute_difference(outputs.data(), f.size(),
+                                                     outputs.data() + f.size() * block_words,
+                                                     f_hat.size(), num_rep, difference.data());
+
+                const std::size_t block_samples =
+                    std::min(BitParallelEvaluator::block_size, samples - block_start);
+                for (std::size_t lane = 0; lane < block_samples; lane++)
+                {
+                    const double value =
+                        abo::util::block_value(difference.data(), difference_bits, lane);
+                    moments.add(std::pow(value, exponent));
+                }
+            }
+            return moments;
+        };
+    };
+
+    return sample_until(make_worker, empirical_bernstein(sample_range), confidence, half_width,
+                        max_samples, threads);
+}
+
+SamplingResult error_rate_sequential_sampling([[maybe_unused]] const Cudd& mgr,
+                                              const std::vector<BDD>& f,
+                                              const std::vector<BDD>& f_hat, double confidence,
+                                              double half_width, long max_samples,
+                                              std::uint64_t seed, unsigned int threads)
+{
+    assert(f.size() == f_hat.size());
+    constexpr std::size_t block_words = BitParallelEvaluator::words_per_block;
+
+    std::vector<BDD> forest = f;
+    forest.insert(forest.end(), f_hat.begin(), f_hat.end());
+    const abo::util::CompiledForest compiled(forest);
+
+    auto make_worker = [&]() -> ChunkFunction {
+        return [&, evaluator = BitParallelEvaluator(compiled)](std::size_t chunk,
+                                                               std::size_t samples) mutable {
+            std::vector<Word> inputs(compiled.num_inputs() * block_words);
+            std::vector<Word> outputs(forest.size() * block_words);
+            abo::util::Xoshiro256StarStar generator(seed, chunk);
+
+            long errors = 0;
+            for (std::size_t block_start = 0; block_start < samples;
+                 block_start += BitParallelEvaluator::block_size)
+            {
+                std::generate(inputs.begin(), inputs.end(), std::ref(generator));
+                evaluator.evaluate(inputs.data(), outputs.data());
+
+                const std::size_t block_samples = samples - block_start;
+                for (std::size_t w = 0; w < block_words; w++)
+                {
+                    Word differs = 0;
+                    for (std::size_t i = 0; i < f.size(); i++)
+                    {
+                        differs |= outputs[i * block_words + w] ^
+                                   outputs[(f.size() + i) * block_words + w];
+                    }
+                    differs &= abo::util::valid_samples_mask(block_samples, w);
+                    errors += __builtin_popcountll(differs);
+                }
+            }
+
+            // the moments of samples that are either zero or one
+            RunningMoments moments;
+            moments.count = static_cast<long>(samples);
+            moments.mean = static_cast<double>(errors) / samples;
+            moments.m2 = errors * (1 - moments.mean);
+            return moments;
+        };
+    };
+
+    return sample_until(make_worker, clopper_pearson, confidence, half_width, max_samples,
+                        threads);
+}
+
+SamplingResult average_case_error_sequential_sampling(
+    [[maybe_unused]] const Cudd& mgr, const std::vector<BDD>& f, const std::vector<BDD>& f_hat,
+    double confidence, double half_width, long max_samples, double value_range,
+    const NumberRepresentation num_rep, std::uint64_t seed, unsigned int threads)
+{
+    return sample_difference(f, f_hat, 1, confidence, half_width, max_samples, value_range,
+                             num_rep, seed, threads);
+}
+
+SamplingResult mean_squared_error_sequential_sampling(
+    [[maybe_unused]] const Cudd& mgr, const std::vector<BDD>& f, const std::vector<BDD>& f_hat,
+    double confidence, double half_width, long max_samples, double value_range,
+    const NumberRepresentation num_rep, std::uint64_t seed, unsigned int threads)
+{
+    return sample_difference(f, f_hat, 2, confidence, half_width, max_samples, value_range,
+                             num_rep, seed, threads);
+}
+
+} // namespace abo::error_metrics
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <cudd/cplusplus/cuddObj.hh>
+#include <vector>
+
+#include "number_representation.hpp"
+
+namespace abo::error_metrics {
+
+/**
+ * @brief The result of a sampling based estimation with a confidence interval
+ */
+struct SamplingResult
+{
+    //! The estimated value of the metric
+    double estimate;
+    //! The lower end of the confidence interval
+    double lower_bound;
+    //! The upper end of the confidence interval
+    double upper_bound;
+    //! The variance of the estimate
+    double variance;
+    //! The number of samples that were drawn
+    long samples;
+};
+
+/**
+ * @brief Estimates the error rate by sampling until the requested accuracy is reached
+ *
+ * Samples are drawn in rounds that double the number of samples. After each round, a
+ * Clopper-Pearson interval is computed and the sampling stops as soon as its half-width is at most
+ * the requested one. The confidence levels of the individual checks are chosen such that the
+ * final interval holds with the requested confidence although several checks are made.
+ *
+ * @param mgr The BDD object manager
+ * @param f The original function
+ * @param f_hat The approximated function. Must have the same number of bits as f
+ * @param confidence The probability with which the error rate lies within the returned interval
+ * @param half_width The desired half-width of the interval
+ * @param max_samples The maximum number of samples to draw. If it is reached, the interval may be
+ * wider than requested. Must be positive, std::invalid_argument is thrown otherwise
+ * @param seed The seed of the random number generator
+ * @param threads The number of threads to use. Zero uses all hardware threads. The result does not
+ * depend on the number of threads
+ * @return The estimated error rate, the confidence interval and the number of samples drawn
+ */
+SamplingResult error_rate_sequential_sampling(const Cudd& mgr, const std::vector<BDD>& f,
+                                              const std::vector<BDD>& f_hat,
+                                              double confidence = 0.99, double half_width = 0.001,
+                                              long max_samples = 1L << 30, std::uint64_t seed = 0,
+                                              unsigned int threads = 1);
+
+/**
+ * @brief Estimates the average case error by sampling until the requested accuracy is reached
+ *
+ * Works like error_rate_sequential_sampling, but uses an empirical Bernstein bound for the
+ * interval. The bound depends on the range of the sampled values, so a known upper bound on the
+ * worst case error (see value_range) can save a lot of samples.
+ *
+ * @param mgr The BDD object manager
+ * @param f The original function
+ * @param f_hat The approximated function
+ * @param confidence The probability with which the error lies within the returned interval
+ * @param half_width The desired half-width of the interval, in the same unit as the error
+ * @param max_samples The maximum number of samples to draw. Must be positive
+ * @param value_range An upper bound on |f - f_hat|. Zero uses the bound implied by the bit widths
+ * @param num_rep The number representation for f and f_hat
+ * @param seed The seed of the random number generator
+ * @param threads The number of threads to use. Zero uses all hardware threads
+ * @return The estimated average case error, the confidence interval and the number of samples drawn
+ */
+SamplingResult average_case_error_sequential_sampling(
+    const Cudd& mgr, const std::vector<BDD>& f, const std::vector<BDD>& f_hat,
+    double confidence, double half_width, long max_samples = 1L << 30, double value_range = 0,
+    const abo::util::NumberRepresentation num_rep = abo::util::NumberRepresentation::BaseTwo,
+    std::uint64_t seed = 0, unsigned int threads = 1);
+
+/**
+ * @brief Estimates the mean squared error by sampling until the requested accuracy is reached
+ *
+ * See average_case_error_sequential_sampling, the sampled values are (f - f_hat)^2.
+ *
+ * @param mgr The BDD object manager
+ * @param f The original function
+ * @param f_hat The approximated function
+ * @param confidence The probability with which the error lies within the returned interval
+ * @param half_width The desired half-width of the interval, in the same unit as the error
+ * @param max_samples The maximum number of samples to draw. Must be positive
+ * @param value_range An upper bound on |f - f_hat|. Zero uses the bound implied by the bit widths
+ * @param num_rep The number representation for f and f_hat
+ * @param seed The seed of the random number generator
+ * @param threads The number of threads to use. Zero uses all hardware threads
+ * @return The estimated mean squared error, the confidence interval and the number of samples drawn
+ */
+SamplingResult mean_squared_error_sequential_sampling(
+    const Cudd& mgr, const std::vector<BDD>& f, const std::vector<BDD>& f_hat,
+    double confidence, double half_width, long max_samples = 1L << 30, double value_range = 0,
+    const abo::util::NumberRepresentation num_rep = abo::util::NumberRepresentation::BaseTwo,
+    std::uint64_t seed = 0, unsigned int threads = 1);
+
+} // namespace abo::error_metrics
@@ -0,0 +1,163 @@
+#include "value_distribution.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <numeric>
+
+#include "compiled_forest.hpp"
+#include "tuple_traversal.hpp"
+
+using boost::multiprecision::cpp_dec_float_100;
+using boost::multiprecision::cpp_int;
+
+namespace abo::error_metrics {
+
+ValueDistribution::ValueDistribution(Counts counts, std::size_t num_variables)
+    : value_counts(std::move(counts)), num_variables(num_variables)
+{
+}
+
+cpp_int ValueDistribution::count(const cpp_int& value) const
+{
+    const auto it = value_counts.find(value);
+    return it == value_counts.end() ? cpp_int(0) : it->second;
+}
+
+cpp_int ValueDistribution::total() const
+{
+    return cpp_int(1) << num_variables;
+}
+
+cpp_dec_float_100 ValueDistribution::mean() const
+{
+    cpp_int sum = 0;
+    for (const auto& [value, count] : value_counts)
+    {
+        sum += value * count;
+    }
+    return cpp_dec_float_100(sum) / cpp_dec_float_100(total());
+}
+
+cpp_dec_float_100 ValueDistribution::mean_square() const
+{
+    cpp_int sum = 0;
+    for (const auto& [value, count] : value_counts)
+    {
+        sum += value * value * count;
+    }
+    return cpp_dec_float_100(sum) / cpp_dec_float_100(total());
+}
+
+cpp_int ValueDistribution::maximum() const
+{
+    return value_counts.empty() ? cpp_int(0) : value_counts.rbegin()->first;
+}
+
+double ValueDistribution::nonzero_rate() const
+{
+    return static_cast<double>(cpp_dec_float_100(total() - count(0)) /
+                               cpp_dec_float_100(total()));
+}
+
+cpp_int ValueDistribution::percentile(double p) const
+{
+    assert(p >= 0 && p <= 1);
+    const cpp_dec_float_100 required = cpp_dec_float_100(p) * cpp_dec_float_100(total());
+    cpp_int covered = 0;
+    for (const auto& [value, count] : value_counts)
+    {
+        covered += count;
+        if (cpp_dec_float_100(covered) >= required)
+        {
+            return value;
+        }
+    }
+    return maximum();
+}
+
+std::vector<cpp_int> ValueDistribution::histogram(const cpp_int& bin_width) const
+{
+    assert(bin_width > 0);
+    std::vector<cpp_int> result(static_cast<std::size_t>(maximum() / bin_width) + 1, 0);
+    for (const auto& [value, count] : value_counts)
+    {
+        result[static_cast<std::size_t>(value / bin_width)] += count;
+    }
+    return result;
+}
+
+//! The distribution of a subfunction over all assignments of the variables from the given level on
+struct LevelCounts
+{
+    unsigned int level;
+    std::shared_ptr<const ValueDistribution::Counts> counts;
+};
+
+ValueDistribution value_distribution(const std::vector<BDD>& f)
+{
+    if (f.empty())
+    {
+        return ValueDistribution({{0, 1}}, 0);
+    }
+
+    const abo::util::CompiledForest forest(f);
+    std::vector<std::size_t> outputs(f.size());
+    std::iota(outputs.begin(), outputs.end(), 0);
+
+    // the distributions are shared between the memoized results instead of being copied
+    const unsigned int terminal_level = static_cast<unsigned int>(forest.num_levels());
+    const LevelCounts root = abo::util::reduce_output_tuples(
+        forest, outputs,
+        [terminal_level](const std::vector<bool>& bits) {
+            cpp_int value = 0;
+            for (std::size_t i = 0; i < bits.size(); i++)
+            {
+                if (bits[i])
+                {
+                    bit_set(value, static_cast<unsigned int>(i));
+                }
+            }
+            return LevelCounts{terminal_level, std::make_shared<ValueDistribution::Counts>(
+                                                   ValueDistribution::Counts{{value, 1}})};
+        },
+        [](const LevelCounts& then_counts, const LevelCounts& else_counts) {
+            // a cofactor claims the counts over all variables from its level on. Any level at most
+            // min(child level) - 1 keeps the two halves weighted equally, as both children are
+            // shifted by the levels between that level and their own, i.e. their counts are taken
+            // over the same variables
+            const unsigned int level = std::min(then_counts.level, else_counts.level) - 1;
+            auto merged = std::make_shared<ValueDistribution::Counts>();
+            for (const LevelCounts* child : {&then_counts, &else_counts})
+            {
+                const unsigned int skipped = child->level - level - 1;
+                for (const auto& [value, count] : *child->counts)
+                {
+                    (*merged)[value] += count << skipped;
+                }
+            }
+            return LevelCounts{level, std::move(merged)};
+        });
+
+    ValueDistribution::Counts counts;
+    for (const auto& [value, count] : *root.counts)
+    {
+        counts.emplace(value, count << root.level);
+    }
+    return ValueDistribution(std::move(counts), forest.num_levels());
+}
+
+ValueDistribution error_distribution(const Cudd& mgr, const std::vector<BDD>& f,
+                                     const std::vector<BDD>& f_hat,
+                                     const abo::util::NumberRepresentation num_rep)
+{
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return error_distribution(context);
+}
+
+ValueDistribution error_distribution(MetricContext& context)
+{
+    return value_distribution(context.absolute_difference());
+}
+
+} // namespace abo::error_metrics
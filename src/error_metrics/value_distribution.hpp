@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cudd/cplusplus/cuddObj.hh>
+#include <map>
+#include <vector>
+
+#include <boost/multiprecision/cpp_dec_float.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+
+#include "metric_context.hpp"
+#include "number_representation.hpp"
+
+namespace abo::error_metrics {
+
+/**
+ * @brief The exact distribution of the unsigned value of a BDD forest over all inputs
+ *
+ * Stores how many inputs lead to each value. All metrics that only depend on the distribution of
+ * the error, e.g. the average case error, the mean squared error, the worst case error and the
+ * error rate, can be read from it without another pass over the functions.
+ */
+class ValueDistribution
+{
+public:
+    //! Maps every value that occurs to the number of inputs with that value
+    using Counts = std::map<boost::multiprecision::cpp_int, boost::multiprecision::cpp_int>;
+
+    /**
+     * @brief Creates the distribution from the counts
+     * @param counts The number of inputs for every value. Values that do not occur are omitted
+     * @param num_variables The number of input variables, the counts must sum up to
+     * 2^num_variables
+     */
+    ValueDistribution(Counts counts, std::size_t num_variables);
+
+    //! Returns the number of inputs for every value that occurs
+    const Counts& counts() const
+    {
+        return value_counts;
+    }
+
+    //! Returns the number of inputs with the given value
+    boost::multiprecision::cpp_int count(const boost::multiprecision::cpp_int& value) const;
+
+    //! Returns the number of inputs, i.e. 2^num_variables
+    boost::multiprecision::cpp_int total() const;
+
+    //! Returns the average value
+    boost::multiprecision::cpp_dec_float_100 mean() const;
+
+    //! Returns the average squared value
+    boost::multiprecision::cpp_dec_float_100 mean_square() const;
+
+    //! Returns the largest value
+    boost::multiprecision::cpp_int maximum() const;
+
+    //! Returns the fraction of inputs with a value other than zero
+    double nonzero_rate() const;
+
+    /**
+     * @brief Returns the smallest value v such that at least the fraction p of the inputs has a
+     * value of at most v
+     * @param p The fraction in the interval [0, 1]
+     */
+    boost::multiprecision::cpp_int percentile(double p) const;
+
+    /**
+     * @brief Returns the number of inputs per bin of the values
+     * @param bin_width The width of the bins. Bin i holds the values in [i * bin_width, (i + 1) *
+     * bin_width)
+     * @return The counts of all bins up to the one holding the largest value
+     */
+    std::vector<boost::multiprecision::cpp_int>
+    histogram(const boost::multiprecision::cpp_int& bin_width) const;
+
+private:
+    Counts value_counts;
+    std::size_t num_variables;
+};
+
+/**
+ * @brief Computes the distribution of the unsigned value of f
+ *
+ * All bits of f are traversed jointly, bottom-up over the distinct joint cofactors of the bits
+ * (see abo::util::reduce_output_tuples). Every cofactor carries the exact distribution of its
+ * subfunction, which is merged from the ones of its children. No ADD is built and the counts are
+ * exact for any width. The cost grows with the number of distinct values of the cofactors, so the
+ * engine is meant for error functions, which usually take few distinct values.
+ *
+ * @param f The function. Bit i has the significance 2^i
+ * @return The number of inputs for every value of f, over all variables of the manager
+ */
+ValueDistribution value_distribution(const std::vector<BDD>& f);
+
+/**
+ * @brief Computes the distribution of the absolute error |f - f_hat|
+ * @param mgr The BDD object manager
+ * @param f The original function
+ * @param f_hat The approximated function. Must have the same number of bits as f
+ * @param num_rep The number representation for f and f_hat
+ * @return The number of inputs for every value of |f - f_hat|
+ */
+ValueDistribution
+error_distribution(const Cudd& mgr, const std::vector<BDD>& f, const std::vector<BDD>& f_hat,
+                   const abo::util::NumberRepresentation num_rep =
+                       abo::util::NumberRepresentation::BaseTwo);
+
+//! Computes error_distribution for the functions of the context, reusing its absolute difference
+ValueDistribution error_distribution(MetricContext& context);
+
+} // namespace abo::error_metrics
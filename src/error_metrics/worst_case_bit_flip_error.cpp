@@ -1,31 +1,71 @@
 #include "worst_case_bit_flip_error.hpp"
 #include "cudd_helpers.hpp"
+#include "incremental_metrics.hpp"
 #include <cassert>
 
+using boost::multiprecision::cpp_int;
+
 namespace abo::error_metrics {
 
+//! Returns the number of differing bits for every input as an ADD
+static ADD bit_error_sum(MetricContext& context)
+{
+    ADD sum = context.manager().addZero();
+    for (const BDD& bit : context.miter())
+    {
+        sum += bit.Add();
+    }
+    return sum;
+}
+
 unsigned int worst_case_bit_flip_error(const Cudd& mgr,
                                        const std::vector<BDD>& f,
                                        const std::vector<BDD>& f_hat)
 {
     assert(f.size() == f_hat.size());
+    MetricContext context(mgr, f, f_hat);
+    return worst_case_bit_flip_error(context);
+}
 
-    ADD bit_error_sum = mgr.addZero();
-    for (unsigned int i = 0; i < f.size(); i++)
+unsigned int worst_case_bit_flip_error(MetricContext& context)
+{
+    if (IncrementalMetrics* base = context.single_output_base())
     {
-        bit_error_sum += (f[i] ^ f_hat[i]).Add();
+        const std::size_t output = context.changed_output();
+        return base->worst_case_bit_flip_error(output, context.approximation()[output]);
     }
 
-    return abo::util::const_ADD_value(bit_error_sum.FindMax());
+    return abo::util::const_ADD_value(bit_error_sum(context).FindMax());
+}
+
+ValueWitness worst_case_bit_flip_error_witness(const Cudd& mgr, const std::vector<BDD>& f,
+                                               const std::vector<BDD>& f_hat)
+{
+    assert(f.size() == f_hat.size());
+    MetricContext context(mgr, f, f_hat);
+    return worst_case_bit_flip_error_witness(context);
+}
+
+ValueWitness worst_case_bit_flip_error_witness(MetricContext& context)
+{
+    const ADD sum = bit_error_sum(context);
+    const unsigned int maximum = abo::util::const_ADD_value(sum.FindMax());
+    const BDD inputs = sum.BddThreshold(maximum);
+    return {maximum, abo::util::pick_satisfying_input(context.manager(), inputs)};
 }
 
 unsigned int worst_case_bit_flip_error_add(const Cudd& mgr,
                                            const std::vector<BDD>& f,
                                            const std::vector<BDD>& f_hat)
 {
-    ADD diff = abo::util::xor_difference_add(mgr, f, f_hat);
-    std::vector<std::pair<double, unsigned long>> terminal_values =
-        abo::util::add_terminal_values(diff);
+    MetricContext context(mgr, f, f_hat);
+    return worst_case_bit_flip_error_add(context);
+}
+
+unsigned int worst_case_bit_flip_error_add(MetricContext& context)
+{
+    std::vector<std::pair<double, cpp_int>> terminal_values =
+        abo::util::add_terminal_values(context.xor_difference_add());
     unsigned int max_flip_error = 0;
     for (auto v : terminal_values)
     {
@@ -3,6 +3,9 @@
 #include <cudd/cplusplus/cuddObj.hh>
 #include <vector>
 
+#include "metric_context.hpp"
+#include "worst_case_error.hpp"
+
 namespace abo::error_metrics {
 
 /**
@@ -17,6 +20,22 @@ unsigned int worst_case_bit_flip_error(const Cudd& mgr,
                                        const std::vector<BDD>& f,
                                        const std::vector<BDD>& f_hat);
 
+//! Computes the worst case bit flip error of the functions of the context, reusing its miter
+unsigned int worst_case_bit_flip_error(MetricContext& context);
+
+/**
+ * @brief Computes the worst case bit flip error together with an input on which it occurs
+ * @param mgr The BDD object manager
+ * @param f The original function
+ * @param f_hat The approximated function. Must have the same number of bits as f
+ * @return The maximum number of differing bits and an input for which it is reached
+ */
+ValueWitness worst_case_bit_flip_error_witness(const Cudd& mgr, const std::vector<BDD>& f,
+                                               const std::vector<BDD>& f_hat);
+
+//! Computes worst_case_bit_flip_error_witness for the functions of the context
+ValueWitness worst_case_bit_flip_error_witness(MetricContext& context);
+
 /**
  * @brief Computes the maximum number of bits that differ in the outputs of f and f_hat for any
  * input The computation is performed symbolically using ADDs
@@ -29,4 +48,7 @@ unsigned int worst_case_bit_flip_error_add(const Cudd& mgr,
                                            const std::vector<BDD>& f,
                                            const std::vector<BDD>& f_hat);
 
+//! Computes worst_case_bit_flip_error_add for the functions of the context, reusing its XOR ADD
+unsigned int worst_case_bit_flip_error_add(MetricContext& context);
+
 } // namespace abo::error_metrics
@@ -5,13 +5,20 @@
 #include "worst_case_error.hpp"
 
 #include <cudd_helpers.hpp>
+#include <limits>
 
 using abo::util::NumberRepresentation;
+using boost::multiprecision::cpp_int;
 using boost::multiprecision::uint256_t;
 
 namespace abo::error_metrics {
 
-uint256_t get_max_value(const Cudd& mgr, const std::vector<BDD>& fun)
+/**
+ * @brief Computes the maximal value of fun on the inputs of the domain
+ * @param domain The inputs to consider. Must not be empty
+ * @return The maximum and the set of all inputs of the domain for which fun takes it
+ */
+static std::pair<uint256_t, BDD> maximum_in_domain(const std::vector<BDD>& fun, const BDD& domain)
 {
 
     /*
@@ -19,10 +26,9 @@ uint256_t get_max_value(const Cudd& mgr, const std::vector<BDD>& fun)
      * significant bit
      */
 
-    BDD sigma = mgr.bddOne();
+    BDD sigma = domain;
 
     uint256_t error = 0U;
-    uint256_t one = 1U;
 
     /*
      * We use iterators instead of explicit indexing using ints as that would (well, let's be
@@ -33,16 +39,40 @@ uint256_t get_max_value(const Cudd& mgr, const std::vector<BDD>& fun)
 
     for (auto iter = fun.rbegin(); iter != fun.rend(); ++iter, --exponent)
     {
-        BDD mask = sigma & *iter;
-
-        if (!mask.IsZero())
+        // sigma & bit is only built if it is not empty, the test itself creates no nodes
+        if (!sigma.Leq(!*iter))
         {
-            error += (one << exponent);
-            sigma = mask;
+            bit_set(error, static_cast<unsigned int>(exponent));
+            sigma &= *iter;
         }
     }
 
-    return error;
+    return {error, sigma};
+}
+
+uint256_t get_max_value(const Cudd& mgr, const std::vector<BDD>& fun)
+{
+    return maximum_in_domain(fun, mgr.bddOne()).first;
+}
+
+ValueWitness get_max_value_witness(const Cudd& mgr, const std::vector<BDD>& fun)
+{
+    const auto [value, inputs] = maximum_in_domain(fun, mgr.bddOne());
+    return {value, abo::util::pick_satisfying_input(mgr, inputs)};
+}
+
+std::vector<ValueWitness> largest_values(const Cudd& mgr, const std::vector<BDD>& fun,
+                                         std::size_t k)
+{
+    std::vector<ValueWitness> result;
+    BDD domain = mgr.bddOne();
+    while (result.size() < k && !domain.IsZero())
+    {
+        const auto [value, inputs] = maximum_in_domain(fun, domain);
+        result.push_back({value, abo::util::pick_satisfying_input(mgr, inputs)});
+        domain &= !inputs;
+    }
+    return result;
 }
 
 uint256_t worst_case_error(const Cudd& mgr,
@@ -50,10 +80,39 @@ uint256_t worst_case_error(const Cudd& mgr,
                             const std::vector<BDD>& f_hat,
                             const NumberRepresentation num_rep)
 {
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return worst_case_error(context);
+}
 
-    std::vector<BDD> absolute_difference =
-        abo::util::bdd_absolute_difference(mgr, f, f_hat, num_rep);
-    return get_max_value(mgr, absolute_difference);
+uint256_t worst_case_error(MetricContext& context)
+{
+    return get_max_value(context.manager(), context.absolute_difference());
+}
+
+ValueWitness worst_case_error_witness(const Cudd& mgr, const std::vector<BDD>& f,
+                                      const std::vector<BDD>& f_hat,
+                                      const NumberRepresentation num_rep)
+{
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return worst_case_error_witness(context);
+}
+
+ValueWitness worst_case_error_witness(MetricContext& context)
+{
+    return get_max_value_witness(context.manager(), context.absolute_difference());
+}
+
+std::vector<ValueWitness> worst_case_errors(const Cudd& mgr, const std::vector<BDD>& f,
+                                            const std::vector<BDD>& f_hat, std::size_t k,
+                                            const NumberRepresentation num_rep)
+{
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return worst_case_errors(context, k);
+}
+
+std::vector<ValueWitness> worst_case_errors(MetricContext& context, std::size_t k)
+{
+    return largest_values(context.manager(), context.absolute_difference(), k);
 }
 
 double worst_case_error_percent(const Cudd& mgr,
@@ -61,8 +120,14 @@ double worst_case_error_percent(const Cudd& mgr,
                                 const std::vector<BDD>& f_hat,
                                 const NumberRepresentation num_rep)
 {
-    double wce = static_cast<double>(worst_case_error(mgr, f, f_hat, num_rep));
-    return wce / (std::pow(2, f.size()) - 1);
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return worst_case_error_percent(context);
+}
+
+double worst_case_error_percent(MetricContext& context)
+{
+    double wce = static_cast<double>(worst_case_error(context));
+    return wce / (std::pow(2, context.original().size()) - 1);
 }
 
 uint256_t worst_case_error_add(const Cudd& mgr,
@@ -70,10 +135,25 @@ uint256_t worst_case_error_add(const Cudd& mgr,
                                 const std::vector<BDD>& f_hat,
                                 const NumberRepresentation num_rep)
 {
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return worst_case_error_add(context);
+}
+
+uint256_t worst_case_error_add(MetricContext& context)
+{
+    if (context.needs_exact_terminals())
+    {
+        cpp_int largest = 0;
+        for (const auto& [value, count] :
+             abo::util::exact_add_terminal_values(context.exact_absolute_difference_add()))
+        {
+            largest = std::max(largest, cpp_int(numerator(value)));
+        }
+        return uint256_t(largest);
+    }
 
-    ADD diff = abo::util::absolute_difference_add(mgr, f, f_hat, num_rep);
-    std::vector<std::pair<double, unsigned long>> terminal_values =
-        abo::util::add_terminal_values(diff);
+    std::vector<std::pair<double, cpp_int>> terminal_values =
+        abo::util::add_terminal_values(context.absolute_difference_add());
 
     uint256_t max_value = 0;
     for (auto p : terminal_values)
@@ -83,10 +163,14 @@ uint256_t worst_case_error_add(const Cudd& mgr,
     return max_value;
 }
 
-uint256_t approximate_worst_case_error(const Cudd& mgr,
-                                      const std::vector<BDD>& f,
-                                      const std::vector<BDD>& f_hat, int n,
-                                      const NumberRepresentation num_rep)
+/**
+ * @brief Computes the worst case error of f and f_hat truncated to n bits below the highest
+ * differing bit
+ * @return {the worst case error of the truncated functions, the number of truncated bits}
+ */
+static std::pair<uint256_t, unsigned long> truncated_worst_case_error(
+    const Cudd& mgr, const std::vector<BDD>& f, const std::vector<BDD>& f_hat, int n,
+    const NumberRepresentation num_rep)
 {
     assert(f.size() == f_hat.size() && n >= 1);
 
@@ -96,6 +180,12 @@ uint256_t approximate_worst_case_error(const Cudd& mgr,
     int bit_start = -1;
     int bit_end = -1;
     int offset = num_rep == NumberRepresentation::TwosComplement ? 1 : 0;
+    // the sign bit is always kept, but if it differs it is the highest differing bit and the
+    // window has to start right below it
+    if (offset == 1 && f.back() != f_hat.back())
+    {
+        bit_start = static_cast<int>(f.size()) - 1;
+    }
     for (int i = static_cast<int>(f.size()) - 1 - offset; i >= 0; i--)
     {
         if (bit_start == -1 && f[i] != f_hat[i])
@@ -112,7 +202,7 @@ uint256_t approximate_worst_case_error(const Cudd& mgr,
     }
     if (bit_start == -1)
     {
-        return 0;
+        return {0, 0};
     }
     std::reverse(f_.begin(), f_.end());
     std::reverse(f_hat_.begin(), f_hat_.end());
@@ -126,10 +216,82 @@ uint256_t approximate_worst_case_error(const Cudd& mgr,
     std::vector<BDD> absolute_difference =
         abo::util::bdd_absolute_difference(mgr, f_, f_hat_, num_rep);
 
-    unsigned long shift = bit_end + 1;
+    return {get_max_value(mgr, absolute_difference), static_cast<unsigned long>(bit_end + 1)};
+}
+
+uint256_t approximate_worst_case_error(const Cudd& mgr,
+                                      const std::vector<BDD>& f,
+                                      const std::vector<BDD>& f_hat, int n,
+                                      const NumberRepresentation num_rep)
+{
+    const auto [truncated, shift] = truncated_worst_case_error(mgr, f, f_hat, n, num_rep);
+    if (truncated == 0 && shift == 0)
+    {
+        return 0;
+    }
     uint256_t one = 1;
     // add one to give an upper bound on the error
-    return (get_max_value(mgr, absolute_difference) + 1) * (one << shift) - 1;
+    return (truncated + 1) * (one << shift) - 1;
+}
+
+uint256_t approximate_worst_case_error(MetricContext& context, int n)
+{
+    return approximate_worst_case_error(context.manager(), context.original(),
+                                        context.approximation(), n,
+                                        context.number_representation());
+}
+
+std::pair<uint256_t, uint256_t> worst_case_error_anytime(const Cudd& mgr,
+                                                         const std::vector<BDD>& f,
+                                                         const std::vector<BDD>& f_hat,
+                                                         const abo::util::ComputationBudget& budget,
+                                                         const NumberRepresentation num_rep)
+{
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return worst_case_error_anytime(context, budget);
+}
+
+std::pair<uint256_t, uint256_t> worst_case_error_anytime(MetricContext& context,
+                                                         const abo::util::ComputationBudget& budget)
+{
+    const abo::util::BudgetMonitor monitor(context.manager(), budget);
+    const uint256_t one = 1;
+
+    uint256_t lower = 0;
+    uint256_t upper = std::numeric_limits<uint256_t>::max();
+    for (int n = 1;; n *= 2)
+    {
+        std::pair<uint256_t, unsigned long> step;
+        try
+        {
+            // the step runs under the remaining budget, an aborted step keeps the last bounds
+            const abo::util::ManagerLimits limits(context.manager(), monitor.remaining());
+            step = truncated_worst_case_error(context.manager(), context.original(),
+                                              context.approximation(), n,
+                                              context.number_representation());
+        }
+        catch (const abo::util::ComputationAborted&)
+        {
+            return {lower, upper};
+        }
+
+        const auto [truncated, shift] = step;
+        if (shift == 0)
+        {
+            return {truncated, truncated};
+        }
+
+        // the truncated low bits change the difference by less than 2^shift in either direction
+        if (truncated > 0)
+        {
+            lower = std::max(lower, (truncated - 1) * (one << shift) + 1);
+        }
+        upper = std::min(upper, uint256_t((truncated + 1) * (one << shift) - 1));
+        if (monitor.exhausted())
+        {
+            return {lower, upper};
+        }
+    }
 }
 
 } // namespace abo::error_metrics
@@ -9,6 +9,8 @@
 #include <cudd/cplusplus/cuddObj.hh>
 #include <vector>
 
+#include "computation_budget.hpp"
+#include "metric_context.hpp"
 #include "number_representation.hpp"
 
 namespace abo::error_metrics {
@@ -24,6 +26,43 @@ namespace abo::error_metrics {
 boost::multiprecision::uint256_t get_max_value(const Cudd& mgr,
                                                const std::vector<BDD>& fun);
 
+/**
+ * @brief A value of a function together with an input for which the function takes it
+ */
+struct ValueWitness
+{
+    boost::multiprecision::uint256_t value;
+    //! The input, one value per variable index of the manager (see cudd BDD.eval)
+    std::vector<int> input;
+};
+
+/**
+ * @brief Computes the maximal value of a function and an input on which it is reached
+ *
+ * Works like get_max_value, which already narrows down the set of inputs reaching the maximum
+ * bit by bit. One of these inputs is picked at the end, so the witness comes almost for free.
+ *
+ * @param mgr The BDD object manager
+ * @param fun The function given by a vector of BDDs. Is interpreted as an unsigned integer
+ * @return The maximum value and an input for which fun returns it
+ */
+ValueWitness get_max_value_witness(const Cudd& mgr, const std::vector<BDD>& fun);
+
+/**
+ * @brief Computes the k largest distinct values of a function, each with an input reaching it
+ *
+ * After a maximum is found, all inputs reaching it are removed from the domain and the search is
+ * repeated on the remaining inputs. Each value therefore costs about as much as one call of
+ * get_max_value.
+ *
+ * @param mgr The BDD object manager
+ * @param fun The function given by a vector of BDDs. Is interpreted as an unsigned integer
+ * @param k The number of values to compute
+ * @return The values in descending order. Fewer than k if the function takes fewer values
+ */
+std::vector<ValueWitness> largest_values(const Cudd& mgr, const std::vector<BDD>& fun,
+                                         std::size_t k);
+
 /**
  * @brief Computes the maximum absolute difference between the f and f_hat for any input
  * The computation is performed symbolically using BDDs
@@ -40,6 +79,47 @@ worst_case_error(const Cudd& mgr,
                  const abo::util::NumberRepresentation num_rep
                     = abo::util::NumberRepresentation::BaseTwo);
 
+/**
+ * @brief Computes the worst case error of the functions of the context
+ * @param context The functions to compare. The absolute difference is taken from the context
+ * @return The maximum absolute difference
+ */
+boost::multiprecision::uint256_t worst_case_error(MetricContext& context);
+
+/**
+ * @brief Computes the worst case error together with an input on which it occurs
+ * @param mgr The BDD object manager
+ * @param f The original function
+ * @param f_hat The approximated function. Must have the same number of bits as f
+ * @param num_rep The number representation for f and f_hat
+ * @return The maximum absolute difference and an input for which it is reached
+ */
+ValueWitness worst_case_error_witness(const Cudd& mgr, const std::vector<BDD>& f,
+                                      const std::vector<BDD>& f_hat,
+                                      const abo::util::NumberRepresentation num_rep =
+                                          abo::util::NumberRepresentation::BaseTwo);
+
+//! Computes worst_case_error_witness for the functions of the context
+ValueWitness worst_case_error_witness(MetricContext& context);
+
+/**
+ * @brief Computes the k largest distinct absolute differences between f and f_hat, see
+ * largest_values
+ * @param mgr The BDD object manager
+ * @param f The original function
+ * @param f_hat The approximated function. Must have the same number of bits as f
+ * @param k The number of distinct errors to compute
+ * @param num_rep The number representation for f and f_hat
+ * @return The errors in descending order, each with an input on which it occurs
+ */
+std::vector<ValueWitness> worst_case_errors(const Cudd& mgr, const std::vector<BDD>& f,
+                                            const std::vector<BDD>& f_hat, std::size_t k,
+                                            const abo::util::NumberRepresentation num_rep =
+                                                abo::util::NumberRepresentation::BaseTwo);
+
+//! Computes worst_case_errors for the functions of the context
+std::vector<ValueWitness> worst_case_errors(MetricContext& context, std::size_t k);
+
 /**
  * @brief Computes the maximum absolute difference between the f and f_hat for any input
  * divided by 2^n - 1 to normalize it to the range [0, 1] regardless of the function size (with n =
@@ -56,6 +136,9 @@ double worst_case_error_percent(const Cudd& mgr, const std::vector<BDD>& f,
                                 const abo::util::NumberRepresentation num_rep
                                     = abo::util::NumberRepresentation::BaseTwo);
 
+//! Computes worst_case_error_percent for the functions of the context
+double worst_case_error_percent(MetricContext& context);
+
 /**
  * @brief Computes the maximum absolute difference between the f and f_hat for any input
  * The computation is performed using BDDs and will be typically slow compared to the BDD based
@@ -73,6 +156,9 @@ worst_case_error_add(const Cudd& mgr,
                      const abo::util::NumberRepresentation num_rep
                         = abo::util::NumberRepresentation::BaseTwo);
 
+//! Computes worst_case_error_add for the functions of the context, reusing its ADD
+boost::multiprecision::uint256_t worst_case_error_add(MetricContext& context);
+
 /**
  * @brief approximate_worst_case_error
  *  Calculates the worst case error approximately, to a given relative error.
@@ -94,4 +180,35 @@ approximate_worst_case_error(const Cudd& mgr, const std::vector<BDD>& f,
                              const abo::util::NumberRepresentation num_rep
                                 = abo::util::NumberRepresentation::BaseTwo);
 
+//! Computes approximate_worst_case_error for the functions of the context. The truncated
+//! subtractor is specific to this metric and not cached
+boost::multiprecision::uint256_t approximate_worst_case_error(MetricContext& context, int n);
+
+/**
+ * @brief Computes bounds on the worst case error that get tighter the longer it runs
+ *
+ * The computation widens the window of approximate_worst_case_error, doubling the number of bits
+ * below the highest differing bit in every step, and keeps the tightest bounds seen so far. It
+ * stops as soon as the window covers all bits, which gives the exact error, or when the budget is
+ * exhausted. Every step runs under the limits of the remaining budget (see
+ * abo::util::ManagerLimits), and a step that exceeds them is aborted and the bounds of the
+ * previous step are returned. If the first step is aborted, the bounds are {0, 2^256 - 1}.
+ *
+ * @param mgr The BDD object manager
+ * @param f The original function
+ * @param f_hat The approximated function. Must have the same number of bits as f
+ * @param budget The time, node and memory limits for the whole computation
+ * @param num_rep The number representation for f and f_hat
+ * @return {min, max}, the bounds on the worst case error. They are equal if the error is exact
+ */
+std::pair<boost::multiprecision::uint256_t, boost::multiprecision::uint256_t>
+worst_case_error_anytime(const Cudd& mgr, const std::vector<BDD>& f,
+                         const std::vector<BDD>& f_hat, const abo::util::ComputationBudget& budget,
+                         const abo::util::NumberRepresentation num_rep =
+                             abo::util::NumberRepresentation::BaseTwo);
+
+//! Computes worst_case_error_anytime for the functions of the context
+std::pair<boost::multiprecision::uint256_t, boost::multiprecision::uint256_t>
+worst_case_error_anytime(MetricContext& context, const abo::util::ComputationBudget& budget);
+
 } // namespace abo::error_metrics
@@ -1,11 +1,21 @@
 #include "worst_case_relative_error.hpp"
+#include "bit_parallel_evaluation.hpp"
 #include "cudd_helpers.hpp"
+#include "parallel_sampling.hpp"
+#include "random.hpp"
+#include "satisfying_input_sampler.hpp"
 #include "worst_case_error.hpp"
 #include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
 #include <set>
 
+using abo::util::BitParallelEvaluator;
 using abo::util::NumberRepresentation;
 using boost::multiprecision::cpp_dec_float_100;
+using boost::multiprecision::cpp_int;
+using boost::multiprecision::uint256_t;
 
 namespace abo::error_metrics {
 
@@ -13,13 +23,25 @@ double wcre_add(const Cudd& mgr, const std::vector<BDD>& f,
                  const std::vector<BDD>& f_hat,
                  const util::NumberRepresentation num_rep)
 {
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return wcre_add(context);
+}
 
-    ADD diff = abo::util::absolute_difference_add(mgr, f, f_hat, num_rep);
-    std::vector<BDD> f_abs = abo::util::bdd_abs(mgr, f, num_rep);
-    ADD respective_diff = diff.Divide(
-        abo::util::bdd_forest_to_add(mgr, f_abs).Maximum(mgr.addOne()));
-    std::vector<std::pair<double, unsigned long>> terminal_values =
-        abo::util::add_terminal_values(respective_diff);
+double wcre_add(MetricContext& context)
+{
+    if (context.needs_exact_terminals())
+    {
+        boost::multiprecision::cpp_rational largest = 0;
+        for (const auto& [value, count] :
+             abo::util::exact_add_terminal_values(context.exact_relative_difference_add()))
+        {
+            largest = std::max(largest, value);
+        }
+        return static_cast<double>(largest);
+    }
+
+    std::vector<std::pair<double, cpp_int>> terminal_values =
+        abo::util::add_terminal_values(context.relative_difference_add());
 
     double largest = 0;
     for (auto p : terminal_values)
@@ -29,6 +51,21 @@ double wcre_add(const Cudd& mgr, const std::vector<BDD>& f,
     return largest;
 }
 
+//! Reads the unsigned number stored in the rows [first_row, first_row + bits) for one input of a block
+static uint256_t block_number(const BitParallelEvaluator::Word* block, std::size_t first_row,
+                             std::size_t bits, std::size_t lane)
+{
+    uint256_t result = 0;
+    for (std::size_t i = 0; i < bits; i++)
+    {
+        if (abo::util::get_block_bit(block, first_row + i, lane))
+        {
+            bit_set(result, static_cast<unsigned int>(i));
+        }
+    }
+    return result;
+}
+
 static std::pair<bool, bool> has_greater_equal_both(const Cudd& mgr, const std::vector<BDD> & f,
                                                     const std::vector<BDD>& g,
                                                     const boost::multiprecision::uint256_t& counter,
@@ -41,15 +78,21 @@ static std::pair<bool, bool> has_greater_equal_both(const Cudd& mgr, const std::
 
 std::pair<long, long> wcre_randomized_search(const Cudd& mgr, const std::vector<BDD>& f,
                                              const std::vector<BDD>& f_hat, unsigned int samples,
-                                             const NumberRepresentation num_rep)
+                                             const NumberRepresentation num_rep,
+                                             std::uint64_t seed, unsigned int threads)
 {
-    std::vector<BDD> f_abs = abo::util::bdd_abs(mgr, f, num_rep);
-    std::vector<BDD> f_ = abo::util::bdd_max_one(mgr, f_abs);
-
-    unsigned int terminal_level = mgr.ReadSize();
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return wcre_randomized_search(context, samples, seed, threads);
+}
 
-    std::vector<BDD> absolute_difference =
-            abo::util::bdd_absolute_difference(mgr, f, f_hat, num_rep);
+std::pair<long, long> wcre_randomized_search(MetricContext& context, unsigned int samples,
+                                             std::uint64_t seed, unsigned int threads)
+{
+    const Cudd& mgr = context.manager();
+    const std::vector<BDD>& f = context.original();
+    const std::vector<BDD>& f_hat = context.approximation();
+    const std::vector<BDD>& f_ = context.original_absolute_max_one();
+    const std::vector<BDD>& absolute_difference = context.absolute_difference();
 
     // shortcut for 0 since the computation will not terminate otherwise
     if (std::all_of(absolute_difference.begin(), absolute_difference.end(), [](const BDD &b) { return b.IsZero(); })) {
@@ -99,6 +142,13 @@ std::pair<long, long> wcre_randomized_search(const Cudd& mgr, const std::vector<
         }
     }
 
+    // the candidates are evaluated a block at a time
+    std::vector<BDD> evaluated = absolute_difference;
+    evaluated.insert(evaluated.end(), f_.begin(), f_.end());
+    const abo::util::CompiledForest compiled(evaluated);
+    // every chunk of samples gets its own random number stream
+    std::uint64_t next_stream = 0;
+
     BDD last_greater = mgr.bddOne();
     {
         std::vector<BDD> bdd_denom = abo::util::bdd_multiply_constant(mgr, absolute_difference, denominator);
@@ -130,12 +180,45 @@ std::pair<long, long> wcre_randomized_search(const Cudd& mgr, const std::vector<
             break;
         }
 
-        // search for the next wcr value
-        std::map<DdNode*, double> minterm_count = abo::util::count_minterms(greater);
-        for (std::size_t i = 0;i<samples;i++) {
-            std::vector<int> next_input = abo::util::random_satisfying_input(greater, minterm_count, terminal_level);
-            long test_counter = abo::util::eval(absolute_difference, next_input);
-            long test_denominator = abo::util::eval(f_, next_input);
+        // search for the next wcr value, every chunk finds its own best fraction
+        const abo::util::CompiledForest compiled_greater({greater});
+        const abo::util::SatisfyingInputSampler sampler(compiled_greater, 0);
+        const std::size_t num_chunks = abo::util::sample_chunk_count(samples);
+        std::vector<std::pair<uint256_t, uint256_t>> chunk_best(num_chunks, {counter, denominator});
+        abo::util::parallel_chunks(num_chunks, threads, [&]() {
+            return [&, evaluator = BitParallelEvaluator(compiled),
+                    inputs = std::vector<BitParallelEvaluator::Word>(
+                            compiled.num_inputs() * BitParallelEvaluator::words_per_block),
+                    outputs = std::vector<BitParallelEvaluator::Word>(
+                            evaluated.size() * BitParallelEvaluator::words_per_block)](
+                    std::size_t chunk) mutable {
+                abo::util::Xoshiro256StarStar generator(seed, next_stream + chunk);
+                const std::size_t chunk_samples = abo::util::samples_in_chunk(samples, chunk);
+                auto& [best_counter, best_denominator] = chunk_best[chunk];
+                for (std::size_t start = 0; start < chunk_samples;
+                     start += BitParallelEvaluator::block_size) {
+                    const std::size_t block_samples =
+                            std::min(BitParallelEvaluator::block_size, chunk_samples - start);
+                    sampler.sample(generator, block_samples, compiled.num_inputs(), inputs.data());
+                    evaluator.evaluate(inputs.data(), outputs.data());
+
+                    for (std::size_t lane = 0; lane < block_samples; lane++) {
+                        uint256_t test_counter =
+                                block_number(outputs.data(), 0, absolute_difference.size(), lane);
+                        uint256_t test_denominator =
+                                block_number(outputs.data(), absolute_difference.size(), f_.size(), lane);
+                        if (test_counter * best_denominator > best_counter * test_denominator) {
+                            best_counter = test_counter;
+                            best_denominator = test_denominator;
+                        }
+                    }
+                }
+            };
+        });
+        next_stream += num_chunks;
+
+        // merge in chunk order so that the result does not depend on the number of threads
+        for (const auto& [test_counter, test_denominator] : chunk_best) {
             if (test_counter * denominator > counter * test_denominator) {
                 counter = test_counter;
                 denominator = test_denominator;
@@ -149,16 +232,31 @@ double wcre_search(const Cudd& mgr, const std::vector<BDD>& f,
                    const std::vector<BDD>& f_hat, unsigned int num_extra_bits,
                    double precision, const NumberRepresentation num_rep)
 {
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return wcre_search(context, num_extra_bits, precision);
+}
 
-    std::vector<BDD> f_abs = abo::util::bdd_abs(mgr, f, num_rep);
-    std::vector<BDD> f_ = abo::util::bdd_max_one(mgr, f_abs);
-
-    std::vector<BDD> absolute_difference =
-            abo::util::bdd_absolute_difference(mgr, f, f_hat, num_rep);
+/**
+ * @brief Searches the worst case relative error with a doubling phase and a bisection
+ * @param stop Called before every step, the search ends once it is true
+ * @param interval {min, max}, the interval that contains the error. Its upper end must be an upper
+ * bound on the error when called. It is narrowed after every step, so it is valid even if a step
+ * throws. Both ends are equal if the exact value was found
+ */
+static void wcre_interval(MetricContext& context, unsigned int num_extra_bits, double precision,
+                          const std::function<bool()>& stop, std::pair<double, double>& interval)
+{
+    double& min = interval.first;
+    double& max = interval.second;
+    const Cudd& mgr = context.manager();
+    // both are extended by the fixed point bits below, so they are copied
+    std::vector<BDD> f_ = context.original_absolute_max_one();
+    std::vector<BDD> absolute_difference = context.absolute_difference();
 
     // shortcut for 0 since the binary search will never reach zero exactly
     if (std::all_of(absolute_difference.begin(), absolute_difference.end(), [](const BDD &b) { return b.IsZero(); })) {
-        return 0;
+        interval = {0, 0};
+        return;
     }
 
     std::vector<BDD> result(num_extra_bits, mgr.bddZero());
@@ -166,16 +264,21 @@ double wcre_search(const Cudd& mgr, const std::vector<BDD>& f,
                                result.begin() + num_extra_bits);
     f_.insert(f_.begin(), result.begin(), result.begin() + num_extra_bits);
 
-    double min;
-    double max;
+    // the absolute difference is below 2^bits and the divisor at least one
+    max = std::min(max, std::pow(2.0, absolute_difference.size() - num_extra_bits));
     BDD last_greater = mgr.bddOne();
     for (float factor = 1.0f;;factor *= 2.0f)
     {
+        if (stop())
+        {
+            return;
+        }
         std::vector<BDD> multiplied = abo::util::bdd_multiply_constant(mgr, f_, factor);
         auto ge = abo::util::exists_greater_equals(mgr, absolute_difference, multiplied);
         if (ge.second)
         { // the correct value was already found
-            return factor;
+            interval = {factor, factor};
+            return;
         }
         if (!ge.first)
         {
@@ -187,8 +290,9 @@ double wcre_search(const Cudd& mgr, const std::vector<BDD>& f,
             min = factor == 1.0 ? 0 : (factor / 2.0);
             break;
         }
+        min = factor;
     }
-    while (max - min > precision)
+    while (max - min > precision && !stop())
     {
         double middle = (min + max) / 2.0;
         std::vector<BDD> reduced_f = f_;
@@ -202,7 +306,8 @@ double wcre_search(const Cudd& mgr, const std::vector<BDD>& f,
         std::vector<BDD> multiplied = abo::util::bdd_multiply_constant(mgr, reduced_f, middle);
         auto ge = abo::util::exists_greater_equals(mgr, reduced_absdiff, multiplied);
         if (ge.second) { // the correct value was already found
-            return middle;
+            interval = {middle, middle};
+            return;
         }
         if (ge.first) {
             min = middle;
@@ -212,22 +317,64 @@ double wcre_search(const Cudd& mgr, const std::vector<BDD>& f,
             max = middle;
         }
     }
-    return (min + max) / 2.0;
+}
+
+double wcre_search(MetricContext& context, unsigned int num_extra_bits, double precision)
+{
+    std::pair<double, double> interval = {0, std::numeric_limits<double>::infinity()};
+    wcre_interval(context, num_extra_bits, precision, []() { return false; }, interval);
+    return (interval.first + interval.second) / 2.0;
+}
+
+std::pair<double, double> wcre_anytime(const Cudd& mgr, const std::vector<BDD>& f,
+                                       const std::vector<BDD>& f_hat,
+                                       const abo::util::ComputationBudget& budget,
+                                       unsigned int num_extra_bits,
+                                       const NumberRepresentation num_rep)
+{
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return wcre_anytime(context, budget, num_extra_bits);
+}
+
+std::pair<double, double> wcre_anytime(MetricContext& context,
+                                       const abo::util::ComputationBudget& budget,
+                                       unsigned int num_extra_bits)
+{
+    const abo::util::BudgetMonitor monitor(context.manager(), budget);
+    // the search only ends by itself once the interval cannot be split with the fixed point bits
+    const double resolution = std::ldexp(1.0, -static_cast<int>(num_extra_bits));
+
+    // |f - f_hat| is below 2^n and the divisor at least one
+    std::pair<double, double> interval = {
+        0, std::ldexp(1.0, static_cast<int>(context.original().size()))};
+    try
+    {
+        // the limits stay installed over all steps, so every step is bounded by the deadline and
+        // the node limit of the whole search. An aborted step leaves the interval of the last one
+        const abo::util::ManagerLimits limits(context.manager(), budget);
+        wcre_interval(context, num_extra_bits, resolution,
+                      [&monitor]() { return monitor.exhausted(); }, interval);
+    }
+    catch (const abo::util::ComputationAborted&)
+    {
+    }
+    return interval;
 }
 
 cpp_dec_float_100 wcre_symbolic_division(
     const Cudd& mgr, const std::vector<BDD>& f, const std::vector<BDD>& f_hat,
     unsigned int num_extra_bits, const NumberRepresentation num_rep)
 {
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return wcre_symbolic_division(context, num_extra_bits);
+}
 
-    std::vector<BDD> absolute_difference =
-        abo::util::bdd_absolute_difference(mgr, f, f_hat, num_rep);
-
-    std::vector<BDD> f_abs = abo::util::bdd_abs(mgr, f, num_rep);
-    std::vector<BDD> no_zero = abo::util::bdd_max_one(mgr, f_abs);
+cpp_dec_float_100 wcre_symbolic_division(MetricContext& context, unsigned int num_extra_bits)
+{
     std::vector<BDD> divided =
-        abo::util::bdd_divide(mgr, absolute_difference, no_zero, num_extra_bits);
-    auto max = get_max_value(mgr, divided);
+        abo::util::bdd_divide(context.manager(), context.absolute_difference(),
+                              context.original_absolute_max_one(), num_extra_bits);
+    auto max = get_max_value(context.manager(), divided);
     cpp_dec_float_100 value(max);
     value /= std::pow(2, num_extra_bits);
     return value;
@@ -271,13 +418,14 @@ std::pair<cpp_dec_float_100, cpp_dec_float_100>
                 const std::vector<BDD>& f_hat,
                 const util::NumberRepresentation num_rep)
 {
+    MetricContext context(mgr, f, f_hat, num_rep);
+    return wcre_bounds(context);
+}
 
-    std::vector<BDD> absolute_difference =
-        abo::util::bdd_absolute_difference(mgr, f, f_hat, num_rep);
-
-    std::vector<BDD> f_abs = abo::util::bdd_abs(mgr, f, num_rep);
-    std::vector<BDD> abs_max_one = abo::util::bdd_max_one(mgr, f_abs);
-    return maximum_relative_value_bounds(mgr, absolute_difference, abs_max_one);
+std::pair<cpp_dec_float_100, cpp_dec_float_100> wcre_bounds(MetricContext& context)
+{
+    return maximum_relative_value_bounds(context.manager(), context.absolute_difference(),
+                                         context.original_absolute_max_one());
 }
 
 } // namespace abo::error_metrics
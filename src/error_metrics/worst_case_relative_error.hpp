@@ -1,9 +1,12 @@
 #pragma once
 
 #include <boost/multiprecision/cpp_dec_float.hpp>
+#include <cstdint>
 #include <cudd/cplusplus/cuddObj.hh>
 #include <vector>
 
+#include "computation_budget.hpp"
+#include "metric_context.hpp"
 #include "number_representation.hpp"
 
 namespace abo::error_metrics {
@@ -24,6 +27,9 @@ double wcre_add(const Cudd& mgr, const std::vector<BDD>& f,
               const abo::util::NumberRepresentation num_rep
                 = abo::util::NumberRepresentation::BaseTwo);
 
+//! Computes wcre_add for the functions of the context, reusing its ADDs
+double wcre_add(MetricContext& context);
+
 /**
  * @brief Computes bounds on the maximum relative value of f in relation to g
  * It is defined as the maximum of |f(x)| / max(1, |g(x)|) over all inputs x
@@ -63,6 +69,11 @@ std::pair<boost::multiprecision::cpp_dec_float_100,
         const abo::util::NumberRepresentation num_rep
             = abo::util::NumberRepresentation::BaseTwo);
 
+//! Computes wcre_bounds for the functions of the context
+std::pair<boost::multiprecision::cpp_dec_float_100,
+            boost::multiprecision::cpp_dec_float_100>
+    wcre_bounds(MetricContext& context);
+
 /**
  * @brief Computes the maximum relative difference between f and f_hat for any input
  * It is defined as the maximum of |f(x) - f_hat(x)| / max(1, |f(x)|) over all inputs x
@@ -88,6 +99,40 @@ double wcre_search(
         const abo::util::NumberRepresentation num_rep
             = abo::util::NumberRepresentation::BaseTwo);
 
+//! Computes wcre_search for the functions of the context
+double wcre_search(MetricContext& context, unsigned int num_extra_bits = 16,
+                   double precision = 0.0001);
+
+/**
+ * @brief Computes bounds on the worst case relative error that get tighter the longer it runs
+ *
+ * Runs the search of wcre_search, which first doubles a lower bound and then bisects the interval,
+ * and returns the current interval once the budget is exhausted. The search runs under the limits
+ * of the budget (see abo::util::ManagerLimits), and a step that exceeds them is aborted and the
+ * interval of the previous step is returned. Without a limit, the search runs until the interval
+ * can not be split with num_extra_bits fixed point bits or the exact value is found.
+ *
+ * @param mgr The BDD object manager
+ * @param f The original function
+ * @param f_hat The approximated function. Must have the same number of bits as f
+ * @param budget The time, node and memory limits for the whole search
+ * @param num_extra_bits The number of additional bits used during the search to represent values
+ * smaller than one
+ * @param num_rep The number representation for f and f_hat
+ * @return {min, max}, the bounds on the worst case relative error
+ */
+std::pair<double, double> wcre_anytime(const Cudd& mgr, const std::vector<BDD>& f,
+                                       const std::vector<BDD>& f_hat,
+                                       const abo::util::ComputationBudget& budget,
+                                       unsigned int num_extra_bits = 16,
+                                       const abo::util::NumberRepresentation num_rep =
+                                           abo::util::NumberRepresentation::BaseTwo);
+
+//! Computes wcre_anytime for the functions of the context
+std::pair<double, double> wcre_anytime(MetricContext& context,
+                                       const abo::util::ComputationBudget& budget,
+                                       unsigned int num_extra_bits = 16);
+
 /**
  * @brief Computes the maximum relative difference between f and f_hat for any input
  * It is defined as the maximum of |f(x) - f_hat(x)| / max(1, |f(x)|) over all inputs x
@@ -100,6 +145,9 @@ double wcre_search(
  * @param f_hat The approximated function. Must have the same number of bits as f
  * @param samples The number of random input samples drawn in each iteration
  * @param num_rep The number representation for f and f_hat
+ * @param seed The seed of the random number generator used to draw the samples
+ * @param threads The number of threads to evaluate the samples with. Zero uses all hardware
+ * threads. The result does not depend on the number of threads
  * @return the maximum relative difference of the inputs as a fraction [numerator, denominator]
  */
 std::pair<long, long> wcre_randomized_search(
@@ -107,7 +155,14 @@ std::pair<long, long> wcre_randomized_search(
         const std::vector<BDD>& f_hat,
         unsigned int samples = 1,
         const abo::util::NumberRepresentation num_rep
-        = abo::util::NumberRepresentation::BaseTwo);
+        = abo::util::NumberRepresentation::BaseTwo,
+        std::uint64_t seed = 0,
+        unsigned int threads = 1);
+
+//! Computes wcre_randomized_search for the functions of the context
+std::pair<long, long> wcre_randomized_search(MetricContext& context, unsigned int samples = 1,
+                                             std::uint64_t seed = 0, unsigned int threads = 1);
+
 /**
  * @brief Computes the maximum relative difference between f and f_hat for any input
  * It is defined as the maximum of |f(x) - f_hat(x)| / max(1, |f(x)|) over all inputs x
@@ -130,4 +185,8 @@ boost::multiprecision::cpp_dec_float_100 wcre_symbolic_division(
         const abo::util::NumberRepresentation num_rep
             = abo::util::NumberRepresentation::BaseTwo);
 
+//! Computes wcre_symbolic_division for the functions of the context
+boost::multiprecision::cpp_dec_float_100 wcre_symbolic_division(MetricContext& context,
+                                                                unsigned int num_extra_bits = 16);
+
 } // namespace abo::error_metrics
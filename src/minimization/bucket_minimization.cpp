@@ -1,8 +1,11 @@
 #include "bucket_minimization.hpp"
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <exception>
 #include <functional>
+#include <memory>
 #include <numeric>
 #include <set>
 #include <tuple>
@@ -16,6 +19,7 @@
 #include "average_case_relative_error.hpp"
 #include "cudd_helpers.hpp"
 #include "error_rate.hpp"
+#include "incremental_metrics.hpp"
 #include "worst_case_bit_flip_error.hpp"
 #include "worst_case_error.hpp"
 #include "worst_case_relative_error.hpp"
@@ -75,6 +79,9 @@ std::vector<Bucket> bucket_greedy_minimize(Cudd& mgr, const std::vector<BDD>& fu
     std::set<std::vector<std::size_t>> test;
     test.insert(create_multi_dim_index(0, bucket_grid_size));
 
+    // the parts of the metrics that only depend on the original function are computed only once
+    auto original = std::make_shared<abo::error_metrics::PreparedOriginal>(mgr, function);
+
     while (!test.empty())
     {
 
@@ -93,6 +100,11 @@ std::vector<Bucket> bucket_greedy_minimize(Cudd& mgr, const std::vector<BDD>& fu
         std::vector<bool> bucket_possible_operators = buckets[current_index].possible_operators;
         std::map<std::size_t, std::size_t> replace_possible_operators;
 
+        // candidates that change a single output of the bucket function update its per-output
+        // partial results instead of recomputing the bit-wise metrics for all outputs
+        auto incremental = std::make_shared<abo::error_metrics::IncrementalMetrics>(
+            mgr, function, bucket_function);
+
         for (std::size_t opnum = 0; opnum < operators.size(); opnum++)
         {
             const auto op = operators[opnum];
@@ -115,13 +127,42 @@ std::vector<Bucket> bucket_greedy_minimize(Cudd& mgr, const std::vector<BDD>& fu
                 continue;
             }
 
-            // compute metric values
+            // compute metric values, sharing the intermediate results between the metrics
+            abo::error_metrics::MetricContext context(original, modified);
+            std::size_t num_changed = 0;
+            std::size_t changed_output = 0;
+            for (std::size_t i = 0; i < modified.size(); i++)
+            {
+                if (modified[i] != bucket_function[i])
+                {
+                    num_changed++;
+                    changed_output = i;
+                }
+            }
+            if (num_changed == 1)
+            {
+                context.set_single_output_change(incremental, changed_output);
+            }
+            // most rejected candidates miss the grid by far, which the cheap bounds already show
             bool better = true;
+            for (std::size_t i = 0; i < num_metrics && better; i++)
+            {
+                if (metrics[i].lower_bound && metrics[i].lower_bound(context) >= metrics[i].bound)
+                {
+                    better = false;
+                    bucket_possible_operators[opnum] = false;
+                }
+            }
+            if (!better)
+            {
+                continue;
+            }
+
             std::vector<std::size_t> new_bucket_index(num_metrics, 0);
             std::vector<double> metric_values(num_metrics);
             for (std::size_t i = 0; i < num_metrics; i++)
             {
-                double error = metrics[i].metric(mgr, function, modified);
+                double error = metrics[i].metric(context);
                 std::size_t dimension_index =
                     std::size_t(bucket_grid_size[i] * error / metrics[i].bound);
                 if (dimension_index >= bucket_grid_size[i])
@@ -300,59 +341,114 @@ std::string metric_to_string(ErrorMetric metric)
     return "";
 }
 
-std::function<double(Cudd&, const std::vector<BDD>&, const std::vector<BDD>&)>
-metric_function(ErrorMetric metric)
+MetricFunction metric_function(ErrorMetric metric)
 {
 
     switch (metric)
     {
     case ErrorMetric::WORST_CASE:
-        return [](Cudd& mgr, const std::vector<BDD>& orig, const std::vector<BDD>& approx) {
-            return static_cast<double>(abo::error_metrics::worst_case_error(mgr, orig, approx));
+        return [](abo::error_metrics::MetricContext& context) {
+            return static_cast<double>(abo::error_metrics::worst_case_error(context));
         };
     case ErrorMetric::WORST_CASE_PERCENT:
-        return [](Cudd& mgr, const std::vector<BDD>& orig, const std::vector<BDD>& approx) {
-            return static_cast<double>(
-                abo::error_metrics::worst_case_error_percent(mgr, orig, approx));
+        return [](abo::error_metrics::MetricContext& context) {
+            return static_cast<double>(abo::error_metrics::worst_case_error_percent(context));
         };
     case ErrorMetric::WORST_CASE_RELATIVE:
-        return [](Cudd& mgr, const std::vector<BDD>& orig, const std::vector<BDD>& approx) {
-            return static_cast<double>(abo::error_metrics::wcre_add(mgr, orig, approx));
+        return [](abo::error_metrics::MetricContext& context) {
+            return static_cast<double>(abo::error_metrics::wcre_add(context));
         };
     case ErrorMetric::AVERAGE_CASE:
-        return [](Cudd& mgr, const std::vector<BDD>& orig, const std::vector<BDD>& approx) {
-            return static_cast<double>(abo::error_metrics::average_case_error(mgr, orig, approx));
+        return [](abo::error_metrics::MetricContext& context) {
+            return static_cast<double>(abo::error_metrics::average_case_error(context));
         };
     case ErrorMetric::AVERAGE_CASE_RELATIVE:
-        return [](Cudd& mgr, const std::vector<BDD>& orig, const std::vector<BDD>& approx) {
-            return static_cast<double>(abo::error_metrics::acre_add(mgr, orig, approx));
+        return [](abo::error_metrics::MetricContext& context) {
+            return static_cast<double>(abo::error_metrics::acre_add(context));
         };
     case ErrorMetric::AVERAGE_CASE_RELATIVE_ADD:
-        return [](Cudd& mgr, const std::vector<BDD>& orig, const std::vector<BDD>& approx) {
-            return static_cast<double>(abo::error_metrics::acre_add(mgr, orig, approx));
+        return [](abo::error_metrics::MetricContext& context) {
+            return static_cast<double>(abo::error_metrics::acre_add(context));
         };
     case ErrorMetric::MEAN_SQUARED:
-        return [](Cudd& mgr, const std::vector<BDD>& orig, const std::vector<BDD>& approx) {
-            return static_cast<double>(abo::error_metrics::mean_squared_error(mgr, orig, approx));
+        return [](abo::error_metrics::MetricContext& context) {
+            return static_cast<double>(abo::error_metrics::mean_squared_error(context));
         };
     case ErrorMetric::ERROR_RATE:
-        return [](Cudd& mgr, const std::vector<BDD>& orig, const std::vector<BDD>& approx) {
-            return static_cast<double>(abo::error_metrics::error_rate(mgr, orig, approx));
+        return [](abo::error_metrics::MetricContext& context) {
+            return static_cast<double>(abo::error_metrics::error_rate(context));
         };
     case ErrorMetric::AVERAGE_BIT_FLIP:
-        return [](Cudd&, const std::vector<BDD>& orig, const std::vector<BDD>& approx) {
-            return static_cast<double>(abo::error_metrics::average_bit_flip_error(orig, approx));
+        return [](abo::error_metrics::MetricContext& context) {
+            return static_cast<double>(abo::error_metrics::average_bit_flip_error(context));
         };
     case ErrorMetric::WORST_CASE_BIT_FLIP:
-        return [](Cudd& mgr, const std::vector<BDD>& orig, const std::vector<BDD>& approx) {
-            return static_cast<double>(
-                abo::error_metrics::worst_case_bit_flip_error(mgr, orig, approx));
+        return [](abo::error_metrics::MetricContext& context) {
+            return static_cast<double>(abo::error_metrics::worst_case_bit_flip_error(context));
         };
     default: throw std::logic_error("switch does not handle all cases");
     }
     throw std::logic_error("switch does not handle all cases");
 }
 
+/**
+ * @brief Returns the largest k for which there is an input where f and f_hat differ in bit k but
+ * in no lower bit, or -1 if the functions are equal
+ * For such an input, f - f_hat is a non-zero multiple of 2^k, so the worst case error is at least
+ * 2^k. Note that a difference in bit k alone does not imply an error of 2^k, e.g. 1000 - 0111 = 1
+ */
+static int lowest_differing_bit_bound(abo::error_metrics::MetricContext& context)
+{
+    const Cudd& mgr = context.manager();
+    const std::vector<BDD>& miter = context.miter();
+    std::vector<BDD> lower_bits_differ;
+    BDD any_differs = mgr.bddZero();
+    for (const BDD& m : miter)
+    {
+        lower_bits_differ.push_back(any_differs);
+        any_differs |= m;
+    }
+    for (std::size_t k = miter.size(); k-- > 0;)
+    {
+        if (!miter[k].Leq(lower_bits_differ[k]))
+        {
+            return static_cast<int>(k);
+        }
+    }
+    return -1;
+}
+
+MetricFunction metric_lower_bound(ErrorMetric metric)
+{
+    switch (metric)
+    {
+    case ErrorMetric::WORST_CASE:
+        return [](abo::error_metrics::MetricContext& context) {
+            const int k = lowest_differing_bit_bound(context);
+            return k < 0 ? 0.0 : std::ldexp(1.0, k);
+        };
+    case ErrorMetric::WORST_CASE_PERCENT:
+        return [](abo::error_metrics::MetricContext& context) {
+            const int k = lowest_differing_bit_bound(context);
+            return k < 0 ? 0.0
+                         : std::ldexp(1.0, k) / (std::pow(2, context.original().size()) - 1);
+        };
+    case ErrorMetric::ERROR_RATE:
+        // every output that differs contributes its inputs to the error rate
+        return [](abo::error_metrics::MetricContext& context) {
+            const int num_vars = context.manager().ReadSize();
+            double result = 0;
+            for (const BDD& m : context.miter())
+            {
+                result = std::max(result, std::ldexp(m.CountMinterm(num_vars), -num_vars));
+            }
+            return result;
+        };
+    default: return MetricFunction();
+    }
+    return MetricFunction();
+}
+
 std::string operator_to_string(Operator op)
 {
     switch (op)
@@ -7,6 +7,8 @@
 
 #include <cudd/cplusplus/cuddObj.hh>
 
+#include "metric_context.hpp"
+
 namespace abo::minimization {
 
 enum class Operator
@@ -97,8 +99,9 @@ enum class ErrorMetric
     WORST_CASE_BIT_FLIP,
 };
 
-typedef std::function<double(Cudd&, const std::vector<BDD>&, const std::vector<BDD>&)>
-    MetricFunction;
+//! Computes an error metric for the original and approximated function of the context. All
+//! metrics of one candidate share the context, so intermediate results are computed only once
+typedef std::function<double(abo::error_metrics::MetricContext&)> MetricFunction;
 
 //! Returns a human readable string version of the enum value passed as argument
 std::string metric_to_string(ErrorMetric metric);
@@ -106,6 +109,13 @@ std::string metric_to_string(ErrorMetric metric);
 //! Returns a lambda computing the error metric given by the argument
 MetricFunction metric_function(ErrorMetric metric);
 
+/**
+ * @brief Returns a lambda computing a cheap lower bound of the error metric given by the argument
+ * The bounds only use the bit-wise miter of the context and avoid building the subtractor. For
+ * metrics without such a bound, an empty function is returned
+ */
+MetricFunction metric_lower_bound(ErrorMetric metric);
+
 //! Holds the configuration for one dimension of the buckets created
 struct MetricDimension
 {
@@ -115,6 +125,9 @@ struct MetricDimension
     MetricFunction metric;
     //! The maximum value of the error metric that is represented by a bucket
     double bound;
+    //! Optional. A lower bound of the metric that is much cheaper to compute. Candidates whose
+    //! lower bound already exceeds bound are rejected without computing the metric
+    MetricFunction lower_bound;
 };
 
 //! A struct holding the information about a bucket. This is also returned as the result of the
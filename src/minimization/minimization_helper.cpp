@@ -66,6 +66,7 @@ MinimizationResult bucket_minimize_helper(const MinimizationInputInfo& info)
         dim.bound = m.bound;
         dim.grid_size = m.grid_size;
         dim.metric = metric_function(m.metric);
+        dim.lower_bound = metric_lower_bound(m.metric);
         metrics.push_back(dim);
     }
     std::vector<OperatorFunction> operator_functions;
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+namespace abo::util {
+
+//! The unsigned integer type between std::uint64_t and arbitrary precision
+using UInt128 = unsigned __int128;
+
+/**
+ * @brief Runs an integer kernel with the fastest accumulator type that is wide enough
+ *
+ * Most sums computed by the metrics, e.g. minterm counts weighted with the significance of their
+ * output bit, have a known bound that only depends on the bit width and the number of variables.
+ * Built-in integers are an order of magnitude faster than boost::multiprecision types, so the
+ * kernel is instantiated for std::uint64_t, UInt128 and cpp_int and the narrowest one that can
+ * hold the bound is called.
+ *
+ * @param bits All values the kernel computes must be below 2^bits
+ * @param kernel A generic callable, called with a zero of the chosen type. The instantiations for
+ * all three types must return the same type
+ * @return The result of the kernel
+ */
+template <typename Kernel>
+auto with_accumulator(std::size_t bits, Kernel kernel)
+{
+    if (bits <= 64)
+    {
+        return kernel(std::uint64_t(0));
+    }
+    if (bits <= 128)
+    {
+        return kernel(UInt128(0));
+    }
+    return kernel(boost::multiprecision::cpp_int(0));
+}
+
+//! Converts the result of an accumulator to an arbitrary precision integer
+inline boost::multiprecision::cpp_int to_cpp_int(UInt128 value)
+{
+    boost::multiprecision::cpp_int result = static_cast<std::uint64_t>(value >> 64);
+    result <<= 64;
+    result |= static_cast<std::uint64_t>(value);
+    return result;
+}
+
+//! Converts the result of an accumulator to an arbitrary precision integer
+inline boost::multiprecision::cpp_int to_cpp_int(std::uint64_t value)
+{
+    return value;
+}
+
+//! Converts the result of an accumulator to an arbitrary precision integer
+inline boost::multiprecision::cpp_int to_cpp_int(const boost::multiprecision::cpp_int& value)
+{
+    return value;
+}
+
+} // namespace abo::util
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cudd/cplusplus/cuddObj.hh>
+
+namespace abo::util {
+
+/**
+ * @brief Measures how many BDD nodes a computation adds to the unique table of a manager
+ *
+ * The counter takes a snapshot of the number of nodes in the unique table (including dead nodes
+ * that were not collected yet) and of the number of garbage collections on construction. Nodes
+ * that are created and thrown away at once, e.g. conjunctions that are only built to test whether
+ * they are zero, show up as growth of the table until the next garbage collection. If a collection
+ * runs in between, the number of allocated nodes is only a lower bound.
+ */
+class AllocationCounter
+{
+public:
+    //! Starts counting for the given manager
+    explicit AllocationCounter(const Cudd& mgr)
+        : mgr(mgr), start_keys(mgr.ReadKeys()), start_collections(mgr.ReadGarbageCollections())
+    {
+    }
+
+    //! Returns the number of nodes added to the unique table since construction
+    long allocated_nodes() const
+    {
+        return static_cast<long>(mgr.ReadKeys()) - static_cast<long>(start_keys);
+    }
+
+    //! Returns the number of garbage collections since construction
+    int garbage_collections() const
+    {
+        return mgr.ReadGarbageCollections() - start_collections;
+    }
+
+    //! Returns whether allocated_nodes() is exact, i.e. no garbage was collected in between
+    bool is_exact() const
+    {
+        return garbage_collections() == 0;
+    }
+
+private:
+    const Cudd& mgr;
+    unsigned int start_keys;
+    int start_collections;
+};
+
+} // namespace abo::util
@@ -0,0 +1,102 @@
+#include "bit_parallel_evaluation.hpp"
+
+#include <algorithm>
+
+namespace abo::util {
+
+BitParallelEvaluator::BitParallelEvaluator(const CompiledForest& forest)
+    : forest(&forest), node_values(forest.num_nodes() * words_per_block)
+{
+}
+
+void BitParallelEvaluator::evaluate(const Word* inputs, Word* outputs)
+{
+    Word* values = node_values.data();
+    for (std::size_t w = 0; w < words_per_block; w++)
+    {
+        values[w] = ~Word(0);
+    }
+
+    for (std::size_t n = 1; n < forest->num_nodes(); n++)
+    {
+        const CompiledForest::Edge then_edge = forest->then_edge(n);
+        const CompiledForest::Edge else_edge = forest->else_edge(n);
+        const Word* x = inputs + forest->variable(n) * words_per_block;
+        const Word* t = values + CompiledForest::edge_node(then_edge) * words_per_block;
+        const Word* e = values + CompiledForest::edge_node(else_edge) * words_per_block;
+        const Word then_complement = -Word(CompiledForest::is_complemented(then_edge));
+        const Word else_complement = -Word(CompiledForest::is_complemented(else_edge));
+        Word* result = values + n * words_per_block;
+        for (std::size_t w = 0; w < words_per_block; w++)
+        {
+            result[w] = (x[w] & (t[w] ^ then_complement)) | (~x[w] & (e[w] ^ else_complement));
+        }
+    }
+
+    for (std::size_t i = 0; i < forest->num_outputs(); i++)
+    {
+        const CompiledForest::Edge root = forest->root(i);
+        const Word* value = values + CompiledForest::edge_node(root) * words_per_block;
+        const Word complement = -Word(CompiledForest::is_complemented(root));
+        for (std::size_t w = 0; w < words_per_block; w++)
+        {
+            outputs[i * words_per_block + w] = value[w] ^ complement;
+        }
+    }
+}
+
+void block_absolute_difference(const BitParallelEvaluator::Word* f, std::size_t f_bits,
+                               const BitParallelEvaluator::Word* g, std::size_t g_bits,
+                               NumberRepresentation num_rep, BitParallelEvaluator::Word* result)
+{
+    using Word = BitParallelEvaluator::Word;
+    constexpr std::size_t words = BitParallelEvaluator::words_per_block;
+
+    // one additional bit makes sure that the difference can not overflow
+    const std::size_t bits = std::max(f_bits, g_bits) + 1;
+    auto extended_bit = [num_rep](const Word* number, std::size_t number_bits, std::size_t i,
+                                  std::size_t w) -> Word {
+        if (i < number_bits)
+        {
+            return number[i * words + w];
+        }
+        // sign extension
+        return num_rep == NumberRepresentation::TwosComplement && number_bits > 0
+                   ? number[(number_bits - 1) * words + w]
+                   : 0;
+    };
+
+    for (std::size_t w = 0; w < words; w++)
+    {
+        Word borrow = 0;
+        for (std::size_t i = 0; i < bits; i++)
+        {
+            const Word a = extended_bit(f, f_bits, i, w);
+            const Word b = extended_bit(g, g_bits, i, w);
+            result[i * words + w] = a ^ b ^ borrow;
+            borrow = (~a & b) | (~(a ^ b) & borrow);
+        }
+
+        // negate the negative differences, i.e. invert them and add one
+        const Word negative = result[(bits - 1) * words + w];
+        Word carry = negative;
+        for (std::size_t i = 0; i < bits; i++)
+        {
+            const Word bit = result[i * words + w] ^ negative;
+            result[i * words + w] = bit ^ carry;
+            carry &= bit;
+        }
+    }
+}
+
+double block_value(const BitParallelEvaluator::Word* block, std::size_t bits, std::size_t index)
+{
+    double value = 0;
+    for (std::size_t i = bits; i-- > 0;)
+    {
+        value = 2 * value + (get_block_bit(block, i, index) ? 1 : 0);
+    }
+    return value;
+}
+
+} // namespace abo::util
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "compiled_forest.hpp"
+#include "number_representation.hpp"
+
+namespace abo::util {
+
+/**
+ * @brief Evaluates a compiled BDD forest for many inputs at once
+ *
+ * An evaluation is a single pass over the nodes of the CompiledForest in which every node computes
+ * its value for a whole block of inputs with word-wide multiplexer operations, instead of walking
+ * the BDDs once per input and output.
+ *
+ * Inputs and outputs are stored bit-sliced: a block consists of words_per_block consecutive words
+ * per variable (or output) and bit j of word w belongs to the input with index 64 * w + j within
+ * the block. The inner loops over the words of a block have a fixed length, so that the compiler
+ * can vectorize them (a block corresponds to one 256 bit register with AVX2).
+ *
+ * The evaluator only holds the node values of the current block. Several evaluators, e.g. one per
+ * thread, can share the same compiled forest.
+ */
+class BitParallelEvaluator
+{
+public:
+    using Word = std::uint64_t;
+
+    //! The number of words that are processed together for each variable, node and output
+    static constexpr std::size_t words_per_block = 4;
+
+    //! The number of inputs that are evaluated with one call to evaluate
+    static constexpr std::size_t block_size = 64 * words_per_block;
+
+    /**
+     * @brief Creates an evaluator for the given forest
+     * @param forest The functions to evaluate. Must outlive the evaluator
+     */
+    explicit BitParallelEvaluator(const CompiledForest& forest);
+
+    //! Returns the number of variables an input block must contain, i.e. the largest variable index
+    //! in the support of the forest plus one
+    std::size_t num_inputs() const
+    {
+        return forest->num_inputs();
+    }
+
+    //! Returns the number of functions in the forest
+    std::size_t num_outputs() const
+    {
+        return forest->num_outputs();
+    }
+
+    /**
+     * @brief Evaluates all functions of the forest for one block of inputs
+     * @param inputs The bit-sliced input values. Must contain num_inputs() * words_per_block words
+     * @param outputs The bit-sliced output values are written here. Must have space for
+     * num_outputs() * words_per_block words
+     */
+    void evaluate(const Word* inputs, Word* outputs);
+
+private:
+    const CompiledForest* forest;
+    //! The values of all nodes for the current block
+    std::vector<Word> node_values;
+};
+
+//! Returns the value with the given index within a block of bit-sliced words
+inline bool get_block_bit(const BitParallelEvaluator::Word* block, std::size_t row,
+                          std::size_t index)
+{
+    return (block[row * BitParallelEvaluator::words_per_block + index / 64] >> (index % 64)) & 1;
+}
+
+//! Returns the mask of the bits of word w of a block that belong to the first block_samples inputs
+inline BitParallelEvaluator::Word valid_samples_mask(std::size_t block_samples, std::size_t w)
+{
+    if (block_samples >= 64 * (w + 1))
+    {
+        return ~BitParallelEvaluator::Word(0);
+    }
+    if (block_samples <= 64 * w)
+    {
+        return 0;
+    }
+    return (BitParallelEvaluator::Word(1) << (block_samples - 64 * w)) - 1;
+}
+
+//! Sets the value with the given index within a block of bit-sliced words
+inline void set_block_bit(BitParallelEvaluator::Word* block, std::size_t row, std::size_t index,
+                          bool value)
+{
+    BitParallelEvaluator::Word& word =
+        block[row * BitParallelEvaluator::words_per_block + index / 64];
+    const BitParallelEvaluator::Word mask = BitParallelEvaluator::Word(1) << (index % 64);
+    word = value ? (word | mask) : (word & ~mask);
+}
+
+/**
+ * @brief Computes |f - g| for all inputs of a block with a word-wide ripple borrow subtractor
+ * @param f The rows of the block holding the bits of f, least significant bit first
+ * @param f_bits The number of bits of f
+ * @param g The rows of the block holding the bits of g, least significant bit first
+ * @param g_bits The number of bits of g
+ * @param num_rep The number representation of f and g
+ * @param result The absolute difference is written here as an unsigned number with
+ * max(f_bits, g_bits) + 1 rows
+ */
+void block_absolute_difference(const BitParallelEvaluator::Word* f, std::size_t f_bits,
+                               const BitParallelEvaluator::Word* g, std::size_t g_bits,
+                               NumberRepresentation num_rep, BitParallelEvaluator::Word* result);
+
+//! Returns the unsigned number stored in the first bits rows of a block for one input as a double
+double block_value(const BitParallelEvaluator::Word* block, std::size_t bits, std::size_t index);
+
+} // namespace abo::util
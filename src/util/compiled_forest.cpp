@@ -0,0 +1,172 @@
+#include "compiled_forest.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "accumulator.hpp"
+#include "node_annotation.hpp"
+
+namespace abo::util {
+
+CompiledForest::CompiledForest(const std::vector<BDD>& forest)
+{
+    // collect all reachable (regular) nodes
+    NodeAnnotation<Edge> node_number;
+    std::vector<DdNode*> nodes;
+    std::vector<DdNode*> stack;
+    for (const BDD& bdd : forest)
+    {
+        stack.push_back(bdd.getRegularNode());
+        while (!stack.empty())
+        {
+            DdNode* node = stack.back();
+            stack.pop_back();
+            if (Cudd_IsConstant(node) || node_number.contains(node))
+            {
+                continue;
+            }
+            node_number[node] = 0;
+            nodes.push_back(node);
+            stack.push_back(Cudd_Regular(Cudd_T(node)));
+            stack.push_back(Cudd_Regular(Cudd_E(node)));
+        }
+    }
+
+    // sort them by level, deepest level first, so that children are numbered before their parents
+    DdManager* dd = forest.empty() ? nullptr : forest.front().manager();
+    if (dd != nullptr)
+    {
+        level_count = static_cast<std::size_t>(Cudd_ReadSize(dd));
+        std::stable_sort(nodes.begin(), nodes.end(), [dd](DdNode* a, DdNode* b) {
+            return Cudd_ReadPerm(dd, Cudd_NodeReadIndex(a)) >
+                   Cudd_ReadPerm(dd, Cudd_NodeReadIndex(b));
+        });
+    }
+    for (std::size_t i = 0; i < nodes.size(); i++)
+    {
+        node_number[nodes[i]] = static_cast<Edge>(i + 1);
+    }
+
+    auto edge_to = [&node_number](DdNode* node) -> Edge {
+        const Edge complement = Cudd_IsComplement(node) ? 1 : 0;
+        DdNode* N = Cudd_Regular(node);
+        return Cudd_IsConstant(N) ? complement : (node_number.at(N) << 1) | complement;
+    };
+
+    variables.reserve(nodes.size() + 1);
+    then_edges.reserve(nodes.size() + 1);
+    else_edges.reserve(nodes.size() + 1);
+    levels.reserve(nodes.size() + 1);
+
+    // the constant one node
+    variables.push_back(0);
+    then_edges.push_back(0);
+    else_edges.push_back(0);
+    levels.push_back(static_cast<unsigned int>(level_count));
+
+    for (DdNode* node : nodes)
+    {
+        variables.push_back(Cudd_NodeReadIndex(node));
+        levels.push_back(static_cast<unsigned int>(Cudd_ReadPerm(dd, Cudd_NodeReadIndex(node))));
+        then_edges.push_back(edge_to(Cudd_T(node)));
+        else_edges.push_back(edge_to(Cudd_E(node)));
+        input_count = std::max<std::size_t>(input_count, Cudd_NodeReadIndex(node) + 1);
+    }
+
+    roots.reserve(forest.size());
+    for (const BDD& bdd : forest)
+    {
+        roots.push_back(edge_to(bdd.getNode()));
+    }
+}
+
+bool CompiledForest::evaluate(std::size_t output, const int* input) const
+{
+    Edge edge = roots[output];
+    bool complemented = false;
+    while (!is_constant(edge))
+    {
+        complemented ^= is_complemented(edge);
+        const std::size_t node = edge_node(edge);
+        edge = input[variables[node]] != 0 ? then_edges[node] : else_edges[node];
+    }
+    return !(complemented ^ is_complemented(edge));
+}
+
+boost::multiprecision::cpp_int CompiledForest::evaluate_number(const std::vector<int>& input) const
+{
+    boost::multiprecision::cpp_int result = 0;
+    for (std::size_t i = 0; i < roots.size(); i++)
+    {
+        if (evaluate(i, input.data()))
+        {
+            bit_set(result, static_cast<unsigned int>(i));
+        }
+    }
+    return result;
+}
+
+std::vector<double> CompiledForest::minterm_fractions() const
+{
+    std::vector<double> fractions(variables.size());
+    fractions[0] = 1.0;
+    for (std::size_t n = 1; n < variables.size(); n++)
+    {
+        fractions[n] = edge_fraction(fractions, then_edges[n]) / 2 +
+                       edge_fraction(fractions, else_edges[n]) / 2;
+    }
+    return fractions;
+}
+
+template <typename Count>
+std::vector<Count> CompiledForest::minterm_counts() const
+{
+    // counts[n] is the number of satisfying assignments of the variables on levels
+    // level(n), ..., num_levels() - 1
+    std::vector<Count> counts(variables.size());
+    counts[0] = 1;
+    auto edge_count = [&](Edge edge) -> Count {
+        const std::size_t node = edge_node(edge);
+        if (is_complemented(edge))
+        {
+            return Count(Count(1) << (level_count - levels[node])) - counts[node];
+        }
+        return counts[node];
+    };
+    for (std::size_t n = 1; n < variables.size(); n++)
+    {
+        // the variables skipped between a node and its child can take any value
+        const unsigned int then_skipped = levels[edge_node(then_edges[n])] - levels[n] - 1;
+        const unsigned int else_skipped = levels[edge_node(else_edges[n])] - levels[n] - 1;
+        counts[n] = Count(edge_count(then_edges[n]) << then_skipped) +
+                    Count(edge_count(else_edges[n]) << else_skipped);
+    }
+
+    std::vector<Count> result;
+    result.reserve(roots.size());
+    for (Edge root : roots)
+    {
+        // and so can the variables above the root
+        result.push_back(Count(edge_count(root) << levels[edge_node(root)]));
+    }
+    return result;
+}
+
+template std::vector<std::uint64_t> CompiledForest::minterm_counts() const;
+template std::vector<UInt128> CompiledForest::minterm_counts() const;
+template std::vector<boost::multiprecision::cpp_int> CompiledForest::minterm_counts() const;
+
+std::vector<boost::multiprecision::cpp_int> CompiledForest::output_minterm_counts() const
+{
+    return with_accumulator(level_count + 1, [this](auto zero) {
+        using Count = decltype(zero);
+        std::vector<boost::multiprecision::cpp_int> result;
+        for (const Count& count : minterm_counts<Count>())
+        {
+            result.push_back(to_cpp_int(count));
+        }
+        return result;
+    });
+}
+
+} // namespace abo::util
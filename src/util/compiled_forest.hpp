@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <boost/multiprecision/cpp_int.hpp>
+#include <cudd/cplusplus/cuddObj.hh>
+
+namespace abo::util {
+
+/**
+ * @brief A read-only snapshot of a BDD forest in a flat, contiguous layout
+ *
+ * The nodes reachable from the functions of the forest are renumbered in level order, starting
+ * with the deepest level, and stored as a struct of arrays: the variable index of every node and
+ * its then and else edges. An edge is the number of the node it points to shifted left by one,
+ * with the complement bit in the lowest bit. Node 0 is the constant one node, so the constant zero
+ * function is the complemented edge 1. As the children of a node are always on a deeper level,
+ * they have smaller node numbers than the node itself, which lets bottom-up kernels simply iterate
+ * over the nodes in ascending order.
+ *
+ * The snapshot does not reference the Cudd manager after construction. It is never modified, so
+ * it can be shared between threads, e.g. to evaluate or sample one function from several threads
+ * at the same time.
+ */
+class CompiledForest
+{
+public:
+    using Edge = std::uint32_t;
+
+    /**
+     * @brief Compiles the given forest. Nodes shared between the functions are stored only once
+     * @param forest The functions to compile. The first function is output 0
+     */
+    explicit CompiledForest(const std::vector<BDD>& forest);
+
+    //! Returns the number of stored nodes, including the constant node
+    std::size_t num_nodes() const
+    {
+        return variables.size();
+    }
+
+    //! Returns the largest variable index in the support of the forest plus one
+    std::size_t num_inputs() const
+    {
+        return input_count;
+    }
+
+    //! Returns the number of functions in the forest
+    std::size_t num_outputs() const
+    {
+        return roots.size();
+    }
+
+    //! Returns the number of variables of the manager at the time of compilation, i.e. the level
+    //! of the constant node
+    std::size_t num_levels() const
+    {
+        return level_count;
+    }
+
+    //! Returns the level of the given node in the variable order. The constant node has level
+    //! num_levels()
+    unsigned int level(std::size_t node) const
+    {
+        return levels[node];
+    }
+
+    //! Returns the variable index of the given node. Must not be called for the constant node 0
+    unsigned int variable(std::size_t node) const
+    {
+        return variables[node];
+    }
+
+    //! Returns the edge to the then child of the given node
+    Edge then_edge(std::size_t node) const
+    {
+        return then_edges[node];
+    }
+
+    //! Returns the edge to the else child of the given node
+    Edge else_edge(std::size_t node) const
+    {
+        return else_edges[node];
+    }
+
+    //! Returns the edge to the root of the given output
+    Edge root(std::size_t output) const
+    {
+        return roots[output];
+    }
+
+    //! Returns the node an edge points to
+    static std::size_t edge_node(Edge edge)
+    {
+        return edge >> 1;
+    }
+
+    //! Returns whether the given edge is complemented
+    static bool is_complemented(Edge edge)
+    {
+        return (edge & 1) != 0;
+    }
+
+    //! Returns whether the given edge points to the constant node
+    static bool is_constant(Edge edge)
+    {
+        return edge_node(edge) == 0;
+    }
+
+    /**
+     * @brief Evaluates one output of the forest
+     * @param output The index of the output
+     * @param input The value for each variable index (see cudd BDD.eval). Must contain at least
+     * num_inputs() values
+     * @return The value of the output
+     */
+    bool evaluate(std::size_t output, const int* input) const;
+
+    /**
+     * @brief Evaluates the forest as an unsigned integer, output i being the bit with significance
+     * 2^i. There is no restriction on the number of outputs
+     * @param input The value for each variable index (see cudd BDD.eval). Must contain at least
+     * num_inputs() values
+     * @return The value of the forest
+     */
+    boost::multiprecision::cpp_int evaluate_number(const std::vector<int>& input) const;
+
+    /**
+     * @brief Computes for every node the fraction of inputs that lead to one when starting from it,
+     * i.e. the same value as count_minterms, but for all nodes of the forest at once
+     * @return The fraction of satisfying inputs of every node (i.e. uncomplemented edge to it)
+     */
+    std::vector<double> minterm_fractions() const;
+
+    /**
+     * @brief Counts the satisfying inputs of every output exactly, over all num_levels() variables
+     *
+     * One bottom-up pass over the nodes counts the satisfying assignments of the variables on and
+     * below the level of every node, so nodes shared by several outputs are visited only once.
+     * Unlike Cudd_CountMinterm, the counts are never rounded.
+     *
+     * @tparam Count std::uint64_t, UInt128 or cpp_int (see accumulator.hpp). Must be able to hold
+     * 2^num_levels()
+     * @return The number of satisfying inputs of every output
+     */
+    template <typename Count>
+    std::vector<Count> minterm_counts() const;
+
+    //! Computes minterm_counts with the narrowest accumulator type that can hold the counts
+    std::vector<boost::multiprecision::cpp_int> output_minterm_counts() const;
+
+    //! Returns the fraction of the node of the given edge, taking its complement into account
+    static double edge_fraction(const std::vector<double>& fractions, Edge edge)
+    {
+        const double value = fractions[edge_node(edge)];
+        return is_complemented(edge) ? 1.0 - value : value;
+    }
+
+private:
+    std::vector<unsigned int> variables;
+    std::vector<Edge> then_edges;
+    std::vector<Edge> else_edges;
+    std::vector<Edge> roots;
+    std::vector<unsigned int> levels;
+    std::size_t input_count = 0;
+    std::size_t level_count = 0;
+};
+
+} // namespace abo::util
@@ -0,0 +1,60 @@
+#include "computation_budget.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
+using Clock = std::chrono::steady_clock;
+
+namespace abo::util {
+
+[[noreturn]] static void abort_computation(std::string message)
+{
+    throw ComputationAborted(message);
+}
+
+//! The termination callback, the argument points to the deadline
+static int deadline_reached(const void* deadline)
+{
+    return Clock::now() >= *static_cast<const Clock::time_point*>(deadline);
+}
+
+ManagerLimits::ManagerLimits(const Cudd& mgr, const ComputationBudget& budget)
+    : mgr(mgr), max_live(mgr.ReadMaxLive()), max_memory(mgr.ReadMaxMemory()),
+      handler(mgr.setHandler(abort_computation)),
+      timeout_handler(mgr.setTimeoutHandler(abort_computation)),
+      termination_handler(mgr.setTerminationHandler(abort_computation)), has_deadline(false)
+{
+    if (budget.live_nodes > 0)
+    {
+        mgr.SetMaxLive(static_cast<unsigned int>(
+            std::min<std::size_t>(budget.live_nodes, std::numeric_limits<unsigned int>::max())));
+    }
+    if (budget.memory > 0)
+    {
+        mgr.SetMaxMemory(budget.memory);
+    }
+    if (budget.time != Clock::duration::max())
+    {
+        deadline = Clock::now() + budget.time;
+        mgr.RegisterTerminationCallback(deadline_reached, &deadline);
+        has_deadline = true;
+    }
+}
+
+ManagerLimits::~ManagerLimits()
+{
+    // a callback of the caller is only touched if a deadline replaced it
+    if (has_deadline)
+    {
+        mgr.UnregisterTerminationCallback();
+    }
+    mgr.SetMaxLive(max_live);
+    mgr.SetMaxMemory(max_memory);
+    mgr.ClearErrorCode();
+    mgr.setHandler(handler);
+    mgr.setTimeoutHandler(timeout_handler);
+    mgr.setTerminationHandler(termination_handler);
+}
+
+} // namespace abo::util
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+
+#include <cudd/cplusplus/cuddObj.hh>
+
+namespace abo::util {
+
+/**
+ * @brief Limits the resources an anytime computation may use
+ *
+ * The node and memory limits and the deadline are installed in the manager for every refinement
+ * step (see ManagerLimits), so a step that exceeds them is aborted and the result of the previous
+ * step is used.
+ */
+struct ComputationBudget
+{
+    //! The wall clock time the computation may take
+    std::chrono::steady_clock::duration time = std::chrono::steady_clock::duration::max();
+    //! The number of live nodes the manager may hold before the computation stops. Zero means no
+    //! limit
+    std::size_t live_nodes = 0;
+    //! The memory in bytes the manager may use. Zero means no limit
+    std::size_t memory = 0;
+};
+
+/**
+ * @brief Tracks the use of a ComputationBudget, starting at construction
+ */
+class BudgetMonitor
+{
+public:
+    BudgetMonitor(const Cudd& mgr, const ComputationBudget& budget)
+        : mgr(mgr), budget(budget), start(std::chrono::steady_clock::now())
+    {
+    }
+
+    //! Returns whether the time or node limit is reached
+    bool exhausted() const
+    {
+        if (budget.live_nodes > 0 &&
+            static_cast<std::size_t>(mgr.ReadNodeCount()) >= budget.live_nodes)
+        {
+            return true;
+        }
+        return budget.time != std::chrono::steady_clock::duration::max() &&
+               std::chrono::steady_clock::now() - start >= budget.time;
+    }
+
+    //! Returns the budget with the time that is left, for the limits of the next step
+    ComputationBudget remaining() const
+    {
+        ComputationBudget result = budget;
+        if (budget.time != std::chrono::steady_clock::duration::max())
+        {
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            result.time = elapsed >= budget.time ? std::chrono::steady_clock::duration::zero()
+                                                 : budget.time - elapsed;
+        }
+        return result;
+    }
+
+private:
+    const Cudd& mgr;
+    ComputationBudget budget;
+    std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * @brief Thrown by the CUDD handlers that ManagerLimits installs when a limit is hit
+ */
+class ComputationAborted : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief Installs the limits of a budget in a manager and restores its previous state on
+ * destruction
+ *
+ * While the object lives, the manager has a limit on the number of live nodes and on its memory,
+ * and a termination callback that checks the wall clock time. The error handlers of the manager
+ * are replaced such that a failed operation throws ComputationAborted. The BDDs of the aborted
+ * computation are released during stack unwinding and their dead nodes are reclaimed by the next
+ * garbage collection.
+ *
+ * The limits are only checked by CUDD, i.e. time spent outside of BDD operations is not
+ * interrupted. CUDD holds a single termination callback and cannot report it, so a budget with a
+ * time limit replaces a callback the caller has registered and removes it on destruction. Without
+ * a time limit, the callback of the caller stays in place.
+ */
+class ManagerLimits
+{
+public:
+    /**
+     * @param mgr The BDD object manager
+     * @param budget The limits. The deadline is the construction time plus the time of the budget.
+     * A live node limit below the number of nodes that are already alive fails the first operation
+     * that creates a node
+     */
+    ManagerLimits(const Cudd& mgr, const ComputationBudget& budget);
+
+    ManagerLimits(const ManagerLimits&) = delete;
+    ManagerLimits& operator=(const ManagerLimits&) = delete;
+
+    ~ManagerLimits();
+
+private:
+    const Cudd& mgr;
+    unsigned int max_live;
+    std::size_t max_memory;
+    PFC handler;
+    PFC timeout_handler;
+    PFC termination_handler;
+    //! Whether the termination callback of the deadline was registered
+    bool has_deadline;
+    std::chrono::steady_clock::time_point deadline;
+};
+
+} // namespace abo::util
@@ -15,6 +15,7 @@
 #include <set>
 #include <stack>
 #include <tuple>
+#include <unordered_map>
 
 namespace abo::util {
 
@@ -35,139 +36,126 @@ unsigned int terminal_level(const std::vector<std::vector<BDD>>& bdds)
     return max_index;
 }
 
-long eval_adder(const std::vector<BDD>& adder,
-                long input1, long input2, int bits)
+boost::multiprecision::cpp_int eval_adder(const std::vector<BDD>& adder,
+                                          long input1, long input2, int bits)
 {
     std::vector<int> bdd_inputs;
     for (int i = 0; i < bits; i++)
     {
-        bdd_inputs.push_back((input1 & (1 << i)) > 0 ? 1 : 0);
-        bdd_inputs.push_back((input2 & (1 << i)) > 0 ? 1 : 0);
+        bdd_inputs.push_back((input1 & (1L << i)) != 0 ? 1 : 0);
+        bdd_inputs.push_back((input2 & (1L << i)) != 0 ? 1 : 0);
     }
 
-    long result = 0;
-    for (unsigned int i = 0; i < adder.size(); i++)
-    {
-        if (adder[i].Eval(bdd_inputs.data()).IsOne())
-        {
-            result |= 1L << i;
-        }
-    }
-
-    return result;
+    return eval(adder, bdd_inputs);
 }
 
-long eval(const std::vector<BDD>& function, std::vector<int> input)
+boost::multiprecision::cpp_int eval(const std::vector<BDD>& function, std::vector<int> input)
 {
-    long result = 0;
+    boost::multiprecision::cpp_int result = 0;
     for (unsigned int i = 0; i < function.size(); i++)
     {
         if (function[i].Eval(input.data()).IsOne())
         {
-            result |= 1L << i;
+            bit_set(result, i);
         }
     }
 
     return result;
 }
 
-static double count_minterms_rec(DdNode* node,
-                                 std::map<DdNode*, double>& minterms_map)
+/**
+ * @brief Annotates every node reachable from root in post-order without using recursion
+ * @param root The node to start from
+ * @param constant_value Computes the value of a (possibly complemented) constant node
+ * @param inner_value Computes the value of an inner node from the node itself and the values of
+ * its (complement adjusted) then and else children
+ */
+template <typename ConstantValue, typename InnerValue>
+static NodeAnnotation<double> annotate_post_order(DdNode* root,
+                                                  ConstantValue constant_value,
+                                                  InnerValue inner_value)
 {
-    auto it = minterms_map.find(node);
-    if (it != minterms_map.end())
-    {
-        return it->second;
-    }
+    NodeAnnotation<double> result;
 
-    if (Cudd_IsConstant(node))
+    // the flag marks whether the children of the node have already been pushed to the stack
+    std::vector<std::pair<DdNode*, bool>> stack;
+    stack.push_back({root, false});
+    while (!stack.empty())
     {
-        double value = Cudd_V(node);
-        if (Cudd_IsComplement(node))
+        auto [node, expanded] = stack.back();
+        stack.pop_back();
+
+        if (result.contains(node))
         {
-            value = value == 0.0 ? 1.0 : 0.0;
+            continue;
         }
-        minterms_map[node] = value;
-        return value;
-    }
-
-    DdNode* N = Cudd_Regular(node);
-
-    DdNode* Nv = Cudd_T(N);
-    DdNode* Nnv = Cudd_E(N);
 
-    Nv = Cudd_NotCond(Nv, Cudd_IsComplement(node));
-    Nnv = Cudd_NotCond(Nnv, Cudd_IsComplement(node));
+        if (Cudd_IsConstant(node))
+        {
+            result[node] = constant_value(node);
+            continue;
+        }
 
-    double highResult = count_minterms_rec(Nv, minterms_map);
-    double lowResult = count_minterms_rec(Nnv, minterms_map);
-    double minTerms = highResult / 2 + lowResult / 2;
+        DdNode* N = Cudd_Regular(node);
+        DdNode* Nv = Cudd_NotCond(Cudd_T(N), Cudd_IsComplement(node));
+        DdNode* Nnv = Cudd_NotCond(Cudd_E(N), Cudd_IsComplement(node));
 
-    minterms_map[node] = minTerms;
-    return minTerms;
-}
+        if (expanded)
+        {
+            result[node] = inner_value(node, Nv, result.at(Nv), Nnv, result.at(Nnv));
+            continue;
+        }
 
-std::map<DdNode*, double> count_minterms(const BDD& bdd)
-{
-    std::map<DdNode*, double> result;
+        stack.push_back({node, true});
+        if (!result.contains(Nv))
+        {
+            stack.push_back({Nv, false});
+        }
+        if (!result.contains(Nnv))
+        {
+            stack.push_back({Nnv, false});
+        }
+    }
 
-    count_minterms_rec(bdd.getNode(), result);
     return result;
 }
 
-static double count_solutions_rec(DdNode* node,
-                                  std::map<DdNode*, double>& solutions_map,
-                                  int terminal_level)
+static double constant_node_value(DdNode* node)
 {
-    auto it = solutions_map.find(node);
-    if (it != solutions_map.end())
-    {
-        return it->second;
-    }
-
-    if (Cudd_IsConstant(node))
+    double value = Cudd_V(node);
+    if (Cudd_IsComplement(node))
     {
-        double value = Cudd_V(node);
-        if (Cudd_IsComplement(node))
-        {
-            value = value == 0.0 ? 1.0 : 0.0;
-        }
-        solutions_map[node] = value;
-        return value;
+        value = value == 0.0 ? 1.0 : 0.0;
     }
+    return value;
+}
 
-    DdNode* N = Cudd_Regular(node);
-
-    DdNode* Nv = Cudd_T(N);
-    DdNode* Nnv = Cudd_E(N);
-
-    Nv = Cudd_NotCond(Nv, Cudd_IsComplement(node));
-    Nnv = Cudd_NotCond(Nnv, Cudd_IsComplement(node));
-
-    double high_result = count_solutions_rec(Nv, solutions_map, terminal_level);
-    double low_result = count_solutions_rec(Nnv, solutions_map, terminal_level);
-
-    unsigned long high_level = Cudd_IsConstant(Nv) ? terminal_level : Cudd_NodeReadIndex(Nv);
-    unsigned long low_level = Cudd_IsConstant(Nnv) ? terminal_level : Cudd_NodeReadIndex(Nnv);
-    unsigned long own_level = Cudd_NodeReadIndex(node);
-
-    double solutions = high_result * std::pow(2.0, high_level - own_level - 1) +
-                       low_result * std::pow(2.0, low_level - own_level - 1);
-
-    solutions_map[node] = solutions;
-    return solutions;
+NodeAnnotation<double> count_minterms(const BDD& bdd)
+{
+    return annotate_post_order(bdd.getNode(), constant_node_value,
+                               [](DdNode*, DdNode*, double high_result, DdNode*,
+                                  double low_result) {
+                                   return high_result / 2 + low_result / 2;
+                               });
 }
 
-std::map<DdNode*, double> count_solutions(const BDD& bdd)
+NodeAnnotation<double> count_solutions(const BDD& bdd)
 {
-    std::map<DdNode*, double> result;
+    const unsigned long terminal = terminal_level({{bdd}});
+    return annotate_post_order(
+        bdd.getNode(), constant_node_value,
+        [terminal](DdNode* node, DdNode* Nv, double high_result, DdNode* Nnv, double low_result) {
+            unsigned long high_level = Cudd_IsConstant(Nv) ? terminal : Cudd_NodeReadIndex(Nv);
+            unsigned long low_level = Cudd_IsConstant(Nnv) ? terminal : Cudd_NodeReadIndex(Nnv);
+            unsigned long own_level = Cudd_NodeReadIndex(node);
 
-    count_solutions_rec(bdd.getNode(), result, terminal_level({{bdd}}));
-    return result;
+            return high_result * std::pow(2.0, high_level - own_level - 1) +
+                   low_result * std::pow(2.0, low_level - own_level - 1);
+        });
 }
 
 std::vector<int> random_satisfying_input(const BDD& bdd,
-                                         const std::map<DdNode*, double>& minterm_count,
+                                         const NodeAnnotation<double>& minterm_count,
                                          int max_level)
 {
     std::vector<int> result;
@@ -212,6 +200,21 @@ std::vector<int> random_satisfying_input(const BDD& bdd,
     return result;
 }
 
+std::vector<int> pick_satisfying_input(const Cudd& mgr, const BDD& bdd)
+{
+    assert(!bdd.IsZero());
+    std::vector<char> cube(static_cast<std::size_t>(mgr.ReadSize()));
+    bdd.PickOneCube(cube.data());
+
+    // PickOneCube marks the variables that do not matter with 2
+    std::vector<int> input(cube.size());
+    for (std::size_t i = 0; i < cube.size(); i++)
+    {
+        input[i] = cube[i] == 1 ? 1 : 0;
+    }
+    return input;
+}
+
 unsigned int const_ADD_value(const ADD& add)
 {
     DdNode* node = add.getNode();
@@ -222,137 +225,187 @@ unsigned int const_ADD_value(const ADD& add)
     return 0;
 }
 
-static std::map<DdNode*, unsigned long> count_paths(DdNode* node,
-                                                    unsigned int terminal_level)
+/**
+ * @brief Counts for every node reachable from root how many of the 2^n inputs of the manager lead
+ * to it
+ *
+ * The nodes are visited level by level from top to bottom. When a node is visited, all of its
+ * parents have already been visited, so its count is final and can be passed on to its children,
+ * multiplied by the number of assignments to the variables skipped by the respective edge.
+ * Complemented edges are kept as separate entries so that the counts stay correct for BDDs as well.
+ */
+static NodeAnnotation<boost::multiprecision::cpp_int> count_paths(DdManager* dd, DdNode* root)
 {
-    if (Cudd_IsConstant(node))
-    {
-        return {{node, 1}};
-    }
-
-    // do a sort of breadth first search, visiting all variable levels from top to bottom
-    std::vector<std::stack<DdNode*>> levels;
-    levels.push_back(std::stack<DdNode*>({Cudd_Regular(node)}));
-
-    std::map<DdNode*, unsigned long> node_to_count;
-    std::set<DdNode*> visited;
-    node_to_count[node] = 1;
-    visited.insert(node);
-    for (unsigned int level = 0; level < levels.size(); level++)
-    {
-        // a reference can not be used here since the vector may resize and move the data elsewhere
-        std::stack<DdNode*> nodes = levels[level];
-        while (nodes.size() > 0)
-        {
-            DdNode* current = nodes.top();
-            nodes.pop();
+    using boost::multiprecision::cpp_int;
 
-            if (Cudd_IsConstant(current)) {
-                continue;
-            }
+    const unsigned int terminal_level = static_cast<unsigned int>(Cudd_ReadSize(dd));
+    auto level_of = [dd, terminal_level](DdNode* node) -> unsigned int {
+        return Cudd_IsConstant(node) ? terminal_level
+                                     : static_cast<unsigned int>(
+                                           Cudd_ReadPerm(dd, Cudd_NodeReadIndex(node)));
+    };
 
-            DdNode* then_node = Cudd_Regular(Cudd_T(current));
-            DdNode* else_node = Cudd_Regular(Cudd_E(current));
+    NodeAnnotation<cpp_int> node_to_count;
+    std::vector<std::vector<DdNode*>> levels(terminal_level + 1);
 
-            unsigned long current_count = node_to_count[current];
+    const unsigned int root_level = level_of(root);
+    node_to_count[root] = cpp_int(1) << root_level;
+    levels[root_level].push_back(root);
 
-            unsigned long then_level =
-                Cudd_IsConstant(then_node) ? terminal_level : Cudd_NodeReadIndex(then_node);
-            // the map will automatically use 0 if the node is not yet present
-            int then_shift_bits = then_level - level - 1;
-            node_to_count[then_node] += current_count << then_shift_bits;
-            if (visited.find(then_node) == visited.end())
-            {
-                levels.resize(std::max(levels.size(), then_level + 1));
-                levels[then_level].push(then_node);
-                visited.insert(then_node);
-            }
+    for (unsigned int level = 0; level < terminal_level; level++)
+    {
+        for (DdNode* current : levels[level])
+        {
+            // copied, as inserting the children may move the stored counts
+            const cpp_int current_count = node_to_count.at(current);
 
-            unsigned long else_level =
-                Cudd_IsConstant(else_node) ? terminal_level : Cudd_NodeReadIndex(else_node);
-            int else_shift_bits = else_level - level - 1;
-            node_to_count[else_node] += current_count << else_shift_bits;
-            if (visited.find(else_node) == visited.end())
+            DdNode* N = Cudd_Regular(current);
+            for (DdNode* child : {Cudd_T(N), Cudd_E(N)})
             {
-                levels.resize(std::max(levels.size(), else_level + 1));
-                levels[else_level].push(else_node);
-                visited.insert(else_node);
+                child = Cudd_NotCond(child, Cudd_IsComplement(current));
+                const unsigned int child_level = level_of(child);
+                cpp_int* child_count = node_to_count.find(child);
+                if (child_count == nullptr)
+                {
+                    child_count = &node_to_count[child];
+                    levels[child_level].push_back(child);
+                }
+                *child_count += current_count << (child_level - level - 1);
             }
         }
+        // the nodes of this level are not needed anymore
+        std::vector<DdNode*>().swap(levels[level]);
     }
 
     return node_to_count;
 }
 
-std::vector<std::pair<double, unsigned long>> add_terminal_values(const ADD& add)
+std::vector<std::pair<double, boost::multiprecision::cpp_int>> add_terminal_values(const ADD& add)
 {
-    std::set<DdNode*> visited;
-    std::stack<DdNode*> toVisit;
-    toVisit.push(add.getNode());
-    visited.insert(add.getNode());
-
-    // determine the level that terminal nodes should be interpreted as
-    std::vector<unsigned int> support = add.SupportIndices();
-    auto max_support_index = std::max_element(support.begin(), support.end());
-    unsigned int term_level = (max_support_index == support.end() ? 0 : *max_support_index) + 1;
-
-    auto path_count = count_paths(add.getNode(), term_level);
+    std::vector<std::pair<double, boost::multiprecision::cpp_int>> result;
+    count_paths(add.manager(), add.getNode())
+        .for_each([&result](DdNode* node, const boost::multiprecision::cpp_int& count) {
+            if (Cudd_IsConstant(node))
+            {
+                result.push_back({Cudd_V(node), count});
+            }
+        });
+    return result;
+}
 
-    std::vector<std::pair<double, unsigned long>> result;
-    while (toVisit.size() > 0)
+//! Hashes a tuple of BDD nodes
+struct NodeTupleHash
+{
+    std::size_t operator()(const std::vector<DdNode*>& tuple) const
     {
-        DdNode* node = toVisit.top();
-        toVisit.pop();
+        std::size_t hash = tuple.size();
+        for (DdNode* node : tuple)
+        {
+            hash ^= std::hash<DdNode*>()(node) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+        }
+        return hash;
+    }
+};
 
+ADD bdd_tuple_to_add(const Cudd& mgr, const std::vector<BDD>& bdds,
+                     const std::function<ADD(const std::vector<bool>&)>& leaf)
+{
+    DdManager* dd = mgr.getManager();
+    const int terminal_level = Cudd_ReadSize(dd);
+    auto level_of = [dd, terminal_level](DdNode* node) -> int {
         if (Cudd_IsConstant(node))
         {
-            result.push_back({Cudd_V(node), path_count[node]});
+            return terminal_level;
         }
-        else
+        return Cudd_ReadPerm(dd, static_cast<int>(Cudd_NodeReadIndex(node)));
+    };
+
+    // the memoized results keep their nodes referenced until the end of the call
+    std::unordered_map<std::vector<DdNode*>, ADD, NodeTupleHash> results;
+    auto build = [&](const std::vector<DdNode*>& tuple, auto& self) -> ADD {
+        auto it = results.find(tuple);
+        if (it != results.end())
+        {
+            return it->second;
+        }
+
+        int level = terminal_level;
+        DdNode* top = nullptr;
+        for (DdNode* node : tuple)
+        {
+            if (level_of(node) < level)
+            {
+                level = level_of(node);
+                top = node;
+            }
+        }
+
+        if (top == nullptr)
         {
-            DdNode* thenNode = Cudd_T(node);
-            if (visited.find(thenNode) == visited.end())
+            // the only constant of a BDD is one, zero is its complement
+            std::vector<bool> values(tuple.size());
+            for (std::size_t i = 0; i < tuple.size(); i++)
             {
-                // cppcheck-suppress stlFindInsert
-                visited.insert(thenNode);
-                toVisit.push(thenNode);
+                values[i] = !Cudd_IsComplement(tuple[i]);
             }
-            DdNode* elseNode = Cudd_E(node);
-            if (visited.find(elseNode) == visited.end())
+            return results.emplace(tuple, leaf(values)).first->second;
+        }
+
+        std::vector<DdNode*> then_tuple = tuple;
+        std::vector<DdNode*> else_tuple = tuple;
+        for (std::size_t i = 0; i < tuple.size(); i++)
+        {
+            if (level_of(tuple[i]) == level)
             {
-                // cppcheck-suppress stlFindInsert
-                visited.insert(elseNode);
-                toVisit.push(elseNode);
+                DdNode* regular = Cudd_Regular(tuple[i]);
+                then_tuple[i] = Cudd_NotCond(Cudd_T(regular), Cudd_IsComplement(tuple[i]));
+                else_tuple[i] = Cudd_NotCond(Cudd_E(regular), Cudd_IsComplement(tuple[i]));
             }
         }
+        const ADD then_result = self(then_tuple, self);
+        const ADD else_result = self(else_tuple, self);
+        const ADD result =
+            then_result == else_result
+                ? then_result
+                : mgr.addVar(static_cast<int>(Cudd_NodeReadIndex(top))).Ite(then_result,
+                                                                            else_result);
+        return results.emplace(tuple, result).first->second;
+    };
+
+    std::vector<DdNode*> roots;
+    roots.reserve(bdds.size());
+    for (const BDD& b : bdds)
+    {
+        roots.push_back(b.getNode());
     }
-    return result;
+    return build(roots, build);
 }
 
-ADD bdd_forest_to_add(const Cudd& mgr, const std::vector<BDD>& bdds,
-                      const NumberRepresentation num_rep)
+//! Returns the value of the bits in the given range in the number representation
+static double bits_value(const std::vector<bool>& bits, std::size_t first, std::size_t count,
+                         const NumberRepresentation num_rep)
 {
-
-    std::vector<BDD> bdds_ = bdds;
-    if (num_rep == NumberRepresentation::BaseTwo)
+    double value = 0;
+    for (std::size_t i = 0; i < count; i++)
     {
-        bdds_.push_back(mgr.bddZero());
+        if (bits[first + i])
+        {
+            value += std::ldexp(1.0, static_cast<int>(i));
+        }
     }
-
-    ADD result = mgr.addZero();
-    ADD two = mgr.addOne() + mgr.addOne();
-    ADD signBitPower = mgr.addOne();
-
-    for (auto it = bdds_.rbegin() + 1; it != bdds_.rend(); it++)
+    if (num_rep == NumberRepresentation::TwosComplement && count > 0 && bits[first + count - 1])
     {
-        result *= two;
-        signBitPower *= two;
-        result += it->Add();
+        value -= std::ldexp(1.0, static_cast<int>(count));
     }
+    return value;
+}
 
-    result -= bdds_.back().Add() * signBitPower;
-
-    return result;
+ADD bdd_forest_to_add(const Cudd& mgr, const std::vector<BDD>& bdds,
+                      const NumberRepresentation num_rep)
+{
+    return bdd_tuple_to_add(mgr, bdds, [&](const std::vector<bool>& bits) {
+        return mgr.constant(bits_value(bits, 0, bits.size(), num_rep));
+    });
 }
 
 ADD xor_difference_add(const Cudd& mgr,
@@ -393,11 +446,19 @@ ADD absolute_difference_add(const Cudd& mgr,
                             const std::vector<BDD>& f_hat,
                             const NumberRepresentation num_rep)
 {
-    ADD a = bdd_forest_to_add(mgr, f, num_rep);
-    ADD b = bdd_forest_to_add(mgr, f_hat, num_rep);
+    std::vector<BDD> both = f;
+    both.insert(both.end(), f_hat.begin(), f_hat.end());
+    return bdd_tuple_to_add(mgr, both, [&](const std::vector<bool>& bits) {
+        return mgr.constant(std::abs(bits_value(bits, 0, f.size(), num_rep) -
+                                     bits_value(bits, f.size(), f_hat.size(), num_rep)));
+    });
+}
+
+ADD absolute_difference_add(const Cudd& mgr, const ADD& f, const ADD& f_hat)
+{
     DdNode* result_node =
         Cudd_addApply(mgr.getManager(), add_absolute_difference_apply,
-                      a.getNode(), b.getNode());
+                      f.getNode(), f_hat.getNode());
 
     return ADD(mgr, result_node);
 }
@@ -505,11 +566,109 @@ std::vector<BDD> bdd_subtract(const Cudd& mgr, const std::vector<BDD>& minuend,
     return diff;
 }
 
+/**
+ * @brief Finds the bits in which f and g may differ
+ *
+ * Bits below low and from high on are the same functions in f and g. The low ones are zero in the
+ * difference and produce no borrow, the high ones cancel out, so f - g = (f[low, high) -
+ * g[low, high)) * 2^low, where the window is an unsigned number unless it contains the sign bit.
+ *
+ * @return {low, high}, or {0, 0} if the bit widths differ and no window is used
+ */
+static std::pair<std::size_t, std::size_t> changed_window(const std::vector<BDD>& f,
+                                                          const std::vector<BDD>& g)
+{
+    if (f.size() != g.size())
+    {
+        return {0, 0};
+    }
+    std::size_t low = 0;
+    while (low < f.size() && f[low] == g[low])
+    {
+        low++;
+    }
+    std::size_t high = f.size();
+    while (high > low && f[high - 1] == g[high - 1])
+    {
+        high--;
+    }
+    return {low, high};
+}
+
+//! Returns whether the window leaves out any bit, so that the computation can be narrowed
+static bool is_narrow_window(const std::vector<BDD>& f, std::pair<std::size_t, std::size_t> window)
+{
+    return window.second > 0 && (window.first > 0 || window.second < f.size());
+}
+
+std::vector<BDD> bdd_difference(const Cudd& mgr, const std::vector<BDD>& f,
+                                const std::vector<BDD>& g, const NumberRepresentation num_rep)
+{
+    const auto window = changed_window(f, g);
+    if (f.size() == g.size() && window.first == window.second)
+    {
+        const std::size_t width =
+            num_rep == NumberRepresentation::BaseTwo ? f.size() + 1 : f.size();
+        return std::vector<BDD>(width, mgr.bddZero());
+    }
+    if (is_narrow_window(f, window))
+    {
+        const auto [low, high] = window;
+        const NumberRepresentation window_rep =
+            high < f.size() ? NumberRepresentation::BaseTwo : num_rep;
+        const std::vector<BDD> window_difference =
+            bdd_difference(mgr, std::vector<BDD>(f.begin() + low, f.begin() + high),
+                           std::vector<BDD>(g.begin() + low, g.begin() + high), window_rep);
+
+        // shift the window back into place and sign extend it to the full width
+        std::vector<BDD> result(low, mgr.bddZero());
+        result.insert(result.end(), window_difference.begin(), window_difference.end());
+        const std::size_t width =
+            num_rep == NumberRepresentation::BaseTwo ? f.size() + 1 : f.size();
+        result.resize(width, result.back());
+        return result;
+    }
+
+    std::vector<BDD> f_ = f;
+    std::vector<BDD> g_ = g;
+
+    if (num_rep == NumberRepresentation::BaseTwo)
+    {
+        f_.push_back(mgr.bddZero());
+        g_.push_back(mgr.bddZero());
+    }
+
+    while (f_.size() < g_.size()) f_.push_back(f_.back());
+    while (g_.size() < f_.size()) g_.push_back(g_.back());
+
+    return bdd_subtract(mgr, f_, g_);
+}
+
 std::vector<BDD> bdd_absolute_difference(const Cudd& mgr,
                                          const std::vector<BDD>& f,
                                          const std::vector<BDD>& g,
                                          const NumberRepresentation num_rep)
 {
+    // only the bits in which f and g differ have to be subtracted
+    const auto window = changed_window(f, g);
+    if (f.size() == g.size() && (window.first == window.second || is_narrow_window(f, window)))
+    {
+        const auto [low, high] = window;
+        std::vector<BDD> result(low, mgr.bddZero());
+        if (low < high)
+        {
+            const NumberRepresentation window_rep =
+                high < f.size() ? NumberRepresentation::BaseTwo : num_rep;
+            const std::vector<BDD> window_difference = bdd_absolute_difference(
+                mgr, std::vector<BDD>(f.begin() + low, f.begin() + high),
+                std::vector<BDD>(g.begin() + low, g.begin() + high), window_rep);
+            result.insert(result.end(), window_difference.begin(), window_difference.end());
+        }
+        const std::size_t width =
+            num_rep == NumberRepresentation::BaseTwo ? f.size() + 1 : f.size();
+        result.resize(width, mgr.bddZero());
+        return result;
+    }
 
     std::vector<BDD> f_ = f;
     std::vector<BDD> g_ = g;
@@ -706,20 +865,23 @@ std::pair<bool, bool> exists_greater_equals(const Cudd& mgr,
 
     equalize_vector_size(mgr, f1_, f2_);
 
+    // the emptiness of the intersections is tested with Leq, which creates no nodes
     BDD zero_condition = mgr.bddOne();
     BDD equal_condition = mgr.bddOne();
     for (int i = int(f1_.size()) - 1; i >= 0; i--)
     {
         zero_condition &= !f2_[i];
-        if (!((f1_[i] & zero_condition).IsZero()))
+        if (!zero_condition.Leq(!f1_[i]))
         {
             return {true, false};
         }
-        if (!((f1_[i] & !f2_[i] & equal_condition).IsZero()))
+        // equal so far and f1 has the bit set, but f2 has not
+        const BDD candidates = equal_condition & f1_[i];
+        if (!candidates.Leq(f2_[i]))
         {
             return {true, false};
         }
-        equal_condition &= (f1_[i] & f2_[i]) | ((!f1_[i]) & (!f2_[i]));
+        equal_condition &= f1_[i].Xnor(f2_[i]);
     }
     if (!equal_condition.IsZero())
     {
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <functional>
 #include <map>
 #include <string>
 #include <vector>
@@ -11,6 +12,7 @@
 #include <cudd/cplusplus/cuddObj.hh>
 #include <boost/multiprecision/cpp_int.hpp>
 
+#include "node_annotation.hpp"
 #include "number_representation.hpp"
 
 namespace abo::util {
@@ -30,31 +32,37 @@ unsigned int terminal_level(const std::vector<std::vector<BDD>>& bdds);
  * @param bits bit width of the adder
  * @return The value of a + b
  */
-long eval_adder(const std::vector<BDD>& adder, long a, long b, int bits);
+boost::multiprecision::cpp_int eval_adder(const std::vector<BDD>& adder, long a, long b,
+                                          int bits);
 
 /**
  * @brief Evaluates the function with the given input
  * @param function Representing an unsigned integer
  * @param input The inputs to the function (see cudd BDD.eval)
- * @return The value of function with the given input
+ * @return The value of function with the given input. There is no restriction on the number of
+ * bits of function. For repeated evaluations, compile the function to a CompiledForest instead
  */
-long eval(const std::vector<BDD>& function, std::vector<int> input);
+boost::multiprecision::cpp_int eval(const std::vector<BDD>& function, std::vector<int> input);
 
 /**
  * @brief count_minterms Counts the number of minterms for each node in the given BDD in percent
  * (between 0 and 1). This counts how many percent of inputs that lead to a given node as an
  * intermediate result also lead to 1.
+ * The nodes are visited in an iterative post-order traversal, so arbitrarily deep BDDs are
+ * supported
  * @param bdd The BDD for which the minters are counted
- * @return A map containing every node in the bdd and its minterm count
+ * @return An annotation containing every node in the bdd and its minterm count
  */
-std::map<DdNode*, double> count_minterms(const BDD& bdd);
+NodeAnnotation<double> count_minterms(const BDD& bdd);
 
 /**
  * @brief count_solutions For each node reachable from the given root, count the number of solutions
+ * The nodes are visited in an iterative post-order traversal, so arbitrarily deep BDDs are
+ * supported
  * @param bdd The root node to search from
- * @return A map containing the number of solutions for each reachable node
+ * @return An annotation containing the number of solutions for each reachable node
  */
-std::map<DdNode*, double> count_solutions(const BDD& bdd);
+NodeAnnotation<double> count_solutions(const BDD& bdd);
 
 /**
  * @brief random_satisfying_input Computes a random variable assignment that satisfies the function
@@ -65,25 +73,57 @@ std::map<DdNode*, double> count_solutions(const BDD& bdd);
  * @param max_level The maximum variable level that should be present in the variable assignment
  * @return A random variable assignment satisfying bdd. The vector consists of zeros and ones,
  * integers are only used for better compatibility with cudd functions
+ * @see SatisfyingInputSampler for drawing many samples at once with a seeded generator
  */
 std::vector<int> random_satisfying_input(const BDD& bdd,
-                                         const std::map<DdNode*, double>& minterm_count,
+                                         const NodeAnnotation<double>& minterm_count,
                                          int max_level);
 
+/**
+ * @brief Picks one satisfying input of a function, without any randomness
+ * @param mgr The BDD object manager
+ * @param bdd The function to satisfy. Must not be the constant zero function
+ * @return A value for every variable index of the manager. Variables the cube picked from bdd does
+ * not depend on are set to zero
+ */
+std::vector<int> pick_satisfying_input(const Cudd& mgr, const BDD& bdd);
+
 //! Returns the value of the given ADD node if it is a constant node and zero otherwise
 unsigned int const_ADD_value(const ADD& add);
 
 /**
  * @brief add_terminal_values Finds all terminal values present in the given ADD and how often each
  * one is reached
+ *
+ * The frequencies are exact integers: the ADD is traversed level by level and the number of
+ * inputs reaching each node is propagated downwards, so the result does not overflow for functions
+ * with many inputs.
+ *
  * @param add The function to compute the terminal values of
  * @return A list of terminal values and their frequencies. The first value of the pair is the
- * terminal node value (unique in the list), the second value is how often it is reached in the ADD
+ * terminal node value (unique in the list), the second value is the number of assignments to all
+ * variables of the manager for which the ADD evaluates to it
+ */
+std::vector<std::pair<double, boost::multiprecision::cpp_int>> add_terminal_values(const ADD& add);
+
+/**
+ * @brief Builds the ADD of a function of the values of several BDDs
+ *
+ * The BDDs are descended jointly, one variable at a time, and every distinct tuple of their
+ * cofactors is visited only once. The ADD is built bottom-up from the results of the tuples, so
+ * no intermediate ADDs are created.
+ *
+ * @param mgr The cudd node manager to create the ADD in
+ * @param bdds The functions to combine
+ * @param leaf Called once all BDDs are constant with their values, returns the terminal
+ * @return The ADD that evaluates to leaf(bdds(x)) for every input x
  */
-std::vector<std::pair<double, unsigned long>> add_terminal_values(const ADD& add);
+ADD bdd_tuple_to_add(const Cudd& mgr, const std::vector<BDD>& bdds,
+                     const std::function<ADD(const std::vector<bool>&)>& leaf);
 
 /**
  * @brief bdd_forest_to_add Computes the ADD equivalent of a function represented by a BDD forest
+ * The ADD is built directly in one memoized descent over all bits, see bdd_tuple_to_add
  * @param mgr The cudd node manager to create the ADD in
  * @param bdds The function to convert to an ADD
  * @param num_rep The number format in which the bdds represent the function
@@ -107,6 +147,8 @@ ADD xor_difference_add(const Cudd& mgr, const std::vector<BDD>& f,
 /**
  * @brief absolute_difference_add Computes the absolute difference between to functions represented
  * as BDDs and returns the result as an ADD
+ * The ADD is built directly in one memoized descent over the bits of both functions, without the
+ * ADDs of f and f_hat
  * @param mgr The cudd node manager to create the ADD in
  * @param f The first function to compute the difference of
  * @param f_hat The second function. Must have the same length as f
@@ -118,6 +160,16 @@ ADD absolute_difference_add(const Cudd& mgr, const std::vector<BDD>& f,
                             const std::vector<BDD>& f_hat,
                             const NumberRepresentation num_rep);
 
+/**
+ * @brief absolute_difference_add Computes the absolute difference between two functions that are
+ * already given as ADDs, e.g. when one of them is compared to many others
+ * @param mgr The cudd node manager to create the ADD in
+ * @param f The first function
+ * @param f_hat The second function
+ * @return An ADD computing |f - f_hat| for each input
+ */
+ADD absolute_difference_add(const Cudd& mgr, const ADD& f, const ADD& f_hat);
+
 /**
  * @brief dump_dot A helper function for calling the dump dot method of cudd for a BDD forest
  * @param mgr The cudd node manager to use
@@ -181,6 +233,21 @@ std::pair<BDD, BDD> full_adder(const BDD& f, const BDD& g, const BDD& carry_in);
 std::vector<BDD> bdd_subtract(const Cudd& mgr, const std::vector<BDD>& minuend,
                               const std::vector<BDD>& subtrahend);
 
+/**
+ * @brief Creates a (vector of) BDDs that represent the signed difference f - g
+ *
+ * The operands are sign extended to a common width. For unsigned numbers, a zero sign bit is added
+ * first, so the result always has enough bits to represent the difference in Two's Complement.
+ *
+ * @param mgr The Cudd object manager
+ * @param f The minuend
+ * @param g The subtrahend
+ * @param num_rep The number representation for f and g
+ * @return BDD computing f - g in Two's Complement
+ */
+std::vector<BDD> bdd_difference(const Cudd& mgr, const std::vector<BDD>& f,
+                                const std::vector<BDD>& g, const NumberRepresentation num_rep);
+
 /**
  * @brief Creates a (vector of) BDDs that represent the absolute difference between to given
  * (vectors of) BDDs
@@ -0,0 +1,200 @@
+#include "exact_add.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <unordered_map>
+
+#include <cudd/cudd/cudd.h>
+
+#include "cudd_helpers.hpp"
+
+using boost::multiprecision::cpp_int;
+using boost::multiprecision::cpp_rational;
+
+namespace abo::util {
+
+std::size_t ExactValueTable::index(const cpp_rational& value)
+{
+    const auto [it, inserted] = indices.emplace(value, values.size());
+    if (inserted)
+    {
+        values.push_back(value);
+    }
+    return it->second;
+}
+
+ExactAdd exact_add_constant(const Cudd& mgr, const cpp_rational& value,
+                            std::shared_ptr<ExactValueTable> table)
+{
+    const double index = static_cast<double>(table->index(value));
+    return ExactAdd(mgr.constant(index), std::move(table));
+}
+
+//! Hashes a pair of ADD nodes
+struct NodePairHash
+{
+    std::size_t operator()(const std::pair<DdNode*, DdNode*>& nodes) const
+    {
+        const std::size_t hash = std::hash<DdNode*>()(nodes.first);
+        return hash ^ (std::hash<DdNode*>()(nodes.second) + 0x9e3779b97f4a7c15ULL + (hash << 6) +
+                       (hash >> 2));
+    }
+};
+
+ExactAdd exact_add_apply(
+    const Cudd& mgr, const ExactAdd& f, const ExactAdd& g,
+    const std::function<cpp_rational(const cpp_rational&, const cpp_rational&)>& op)
+{
+    assert(f.table() == g.table());
+    ExactValueTable& table = *f.table();
+    DdManager* dd = mgr.getManager();
+
+    auto level_of = [dd](DdNode* node) -> int {
+        if (Cudd_IsConstant(node))
+        {
+            return Cudd_ReadSize(dd);
+        }
+        return Cudd_ReadPerm(dd, static_cast<int>(Cudd_NodeReadIndex(node)));
+    };
+
+    // the memoized results keep their nodes referenced until the end of the call
+    std::unordered_map<std::pair<DdNode*, DdNode*>, ADD, NodePairHash> results;
+    auto apply = [&](DdNode* F, DdNode* G, auto& self) -> ADD {
+        auto it = results.find({F, G});
+        if (it != results.end())
+        {
+            return it->second;
+        }
+
+        if (Cudd_IsConstant(F) && Cudd_IsConstant(G))
+        {
+            const cpp_rational value = op(table.value(static_cast<std::size_t>(Cudd_V(F))),
+                                          table.value(static_cast<std::size_t>(Cudd_V(G))));
+            const ADD result = mgr.constant(static_cast<double>(table.index(value)));
+            return results.emplace(std::make_pair(F, G), result).first->second;
+        }
+
+        // ADDs have no complemented edges, so the children can be used directly
+        const int level = std::min(level_of(F), level_of(G));
+        const bool split_f = level_of(F) == level;
+        const bool split_g = level_of(G) == level;
+        const ADD then_result =
+            self(split_f ? Cudd_T(F) : F, split_g ? Cudd_T(G) : G, self);
+        const ADD else_result =
+            self(split_f ? Cudd_E(F) : F, split_g ? Cudd_E(G) : G, self);
+
+        const int index = static_cast<int>(Cudd_NodeReadIndex(split_f ? F : G));
+        const ADD result = then_result == else_result
+                               ? then_result
+                               : mgr.addVar(index).Ite(then_result, else_result);
+        return results.emplace(std::make_pair(F, G), result).first->second;
+    };
+
+    return ExactAdd(apply(f.indices().getNode(), g.indices().getNode(), apply), f.table());
+}
+
+ExactAdd exact_add_reindex(const Cudd& mgr, const ExactAdd& f,
+                           std::shared_ptr<ExactValueTable> table)
+{
+    if (f.table() == table)
+    {
+        return f;
+    }
+
+    // distinct values stay distinct, so the result has the same structure as f
+    std::unordered_map<DdNode*, ADD> results;
+    auto reindex = [&](DdNode* F, auto& self) -> ADD {
+        auto it = results.find(F);
+        if (it != results.end())
+        {
+            return it->second;
+        }
+
+        ADD result;
+        if (Cudd_IsConstant(F))
+        {
+            const std::size_t index = static_cast<std::size_t>(Cudd_V(F));
+            result = mgr.constant(static_cast<double>(table->index(f.table()->value(index))));
+        }
+        else
+        {
+            const ADD then_result = self(Cudd_T(F), self);
+            const ADD else_result = self(Cudd_E(F), self);
+            const int index = static_cast<int>(Cudd_NodeReadIndex(F));
+            result = mgr.addVar(index).Ite(then_result, else_result);
+        }
+        return results.emplace(F, result).first->second;
+    };
+
+    return ExactAdd(reindex(f.indices().getNode(), reindex), std::move(table));
+}
+
+ExactAdd exact_add_plus(const Cudd& mgr, const ExactAdd& f, const ExactAdd& g)
+{
+    return exact_add_apply(mgr, f, g, [](const cpp_rational& a, const cpp_rational& b) {
+        return cpp_rational(a + b);
+    });
+}
+
+ExactAdd exact_add_minus(const Cudd& mgr, const ExactAdd& f, const ExactAdd& g)
+{
+    return exact_add_apply(mgr, f, g, [](const cpp_rational& a, const cpp_rational& b) {
+        return cpp_rational(a - b);
+    });
+}
+
+ExactAdd exact_absolute_difference_add(const Cudd& mgr, const ExactAdd& f, const ExactAdd& g)
+{
+    return exact_add_apply(mgr, f, g, [](const cpp_rational& a, const cpp_rational& b) {
+        return a > b ? cpp_rational(a - b) : cpp_rational(b - a);
+    });
+}
+
+ExactAdd exact_add_divide(const Cudd& mgr, const ExactAdd& f, const ExactAdd& g)
+{
+    return exact_add_apply(mgr, f, g, [](const cpp_rational& a, const cpp_rational& b) {
+        return cpp_rational(a / b);
+    });
+}
+
+ExactAdd exact_add_maximum(const Cudd& mgr, const ExactAdd& f, const ExactAdd& g)
+{
+    return exact_add_apply(mgr, f, g, [](const cpp_rational& a, const cpp_rational& b) {
+        return std::max(a, b);
+    });
+}
+
+ExactAdd bdd_forest_to_exact_add(const Cudd& mgr, const std::vector<BDD>& bdds,
+                                 std::shared_ptr<ExactValueTable> table,
+                                 const NumberRepresentation num_rep)
+{
+    const bool is_signed = num_rep == NumberRepresentation::TwosComplement;
+    const ADD indices = bdd_tuple_to_add(mgr, bdds, [&](const std::vector<bool>& bits) {
+        cpp_int value = 0;
+        for (std::size_t i = 0; i < bits.size(); i++)
+        {
+            if (bits[i])
+            {
+                bit_set(value, static_cast<unsigned int>(i));
+            }
+        }
+        if (is_signed && !bits.empty() && bits.back())
+        {
+            value -= cpp_int(1) << bits.size();
+        }
+        return mgr.constant(static_cast<double>(table->index(value)));
+    });
+    return ExactAdd(indices, std::move(table));
+}
+
+std::vector<std::pair<cpp_rational, cpp_int>> exact_add_terminal_values(const ExactAdd& add)
+{
+    std::vector<std::pair<cpp_rational, cpp_int>> result;
+    for (const auto& [index, count] : add_terminal_values(add.indices()))
+    {
+        result.emplace_back(add.table()->value(static_cast<std::size_t>(index)), count);
+    }
+    return result;
+}
+
+} // namespace abo::util
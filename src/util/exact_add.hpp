@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <boost/multiprecision/cpp_int.hpp>
+#include <cudd/cplusplus/cuddObj.hh>
+
+#include "number_representation.hpp"
+
+namespace abo::util {
+
+/**
+ * @brief Stores the exact values that the terminals of ExactAdds stand for
+ *
+ * The terminals of an ADD are doubles, which represent integers exactly only up to 2^53. An
+ * ExactAdd instead stores the index of its value in this table in each terminal, and every value
+ * is stored only once, so equal values still share their terminal.
+ */
+class ExactValueTable
+{
+public:
+    //! Returns the index of the value, adding it to the table if it is not present yet
+    std::size_t index(const boost::multiprecision::cpp_rational& value);
+
+    //! Returns the value with the given index
+    const boost::multiprecision::cpp_rational& value(std::size_t index) const
+    {
+        return values[index];
+    }
+
+    //! Returns the number of distinct values in the table
+    std::size_t size() const
+    {
+        return values.size();
+    }
+
+private:
+    std::vector<boost::multiprecision::cpp_rational> values;
+    std::map<boost::multiprecision::cpp_rational, std::size_t> indices;
+};
+
+/**
+ * @brief An ADD with arbitrary precision rational terminals
+ *
+ * The terminals of the ADD are indices into an ExactValueTable. Two ExactAdds can only be combined
+ * if they share their table. The ADD operators of CUDD must not be used on the indices, use
+ * exact_add_apply instead.
+ */
+class ExactAdd
+{
+public:
+    ExactAdd(const ADD& indices, std::shared_ptr<ExactValueTable> table)
+        : index_add(indices), value_table(std::move(table))
+    {
+    }
+
+    //! Returns the ADD of the indices of the values
+    const ADD& indices() const
+    {
+        return index_add;
+    }
+
+    //! Returns the table of the values
+    const std::shared_ptr<ExactValueTable>& table() const
+    {
+        return value_table;
+    }
+
+private:
+    ADD index_add;
+    std::shared_ptr<ExactValueTable> value_table;
+};
+
+//! Returns the ExactAdd of the constant function with the given value
+ExactAdd exact_add_constant(const Cudd& mgr, const boost::multiprecision::cpp_rational& value,
+                            std::shared_ptr<ExactValueTable> table);
+
+/**
+ * @brief Applies a binary operator to the values of two ExactAdds
+ *
+ * Works like Cudd_addApply, but the results are memoized per call instead of in the computed table
+ * of the manager, as the indices of different tables mean different values.
+ *
+ * @param mgr The cudd node manager to create the result in
+ * @param f The left operand
+ * @param g The right operand. Must use the same table as f
+ * @param op Computes the value of the result from the values of f and g
+ * @return The ExactAdd of op(f, g), using the table of f
+ */
+ExactAdd exact_add_apply(
+    const Cudd& mgr, const ExactAdd& f, const ExactAdd& g,
+    const std::function<boost::multiprecision::cpp_rational(
+        const boost::multiprecision::cpp_rational&, const boost::multiprecision::cpp_rational&)>&
+        op);
+
+/**
+ * @brief Stores the values of an ExactAdd in another table
+ *
+ * Allows to combine ExactAdds of different tables, e.g. one that is shared by many computations
+ * with one whose values are only needed for a single computation.
+ *
+ * @param mgr The cudd node manager to create the result in
+ * @param f The ExactAdd to copy
+ * @param table The table for the values of the result
+ * @return The ExactAdd with the same values as f, using the given table
+ */
+ExactAdd exact_add_reindex(const Cudd& mgr, const ExactAdd& f,
+                           std::shared_ptr<ExactValueTable> table);
+
+//! Returns the ExactAdd of f + g
+ExactAdd exact_add_plus(const Cudd& mgr, const ExactAdd& f, const ExactAdd& g);
+
+//! Returns the ExactAdd of f - g
+ExactAdd exact_add_minus(const Cudd& mgr, const ExactAdd& f, const ExactAdd& g);
+
+//! Returns the ExactAdd of |f - g|
+ExactAdd exact_absolute_difference_add(const Cudd& mgr, const ExactAdd& f, const ExactAdd& g);
+
+//! Returns the ExactAdd of f / g. g must not be zero for any input
+ExactAdd exact_add_divide(const Cudd& mgr, const ExactAdd& f, const ExactAdd& g);
+
+//! Returns the ExactAdd of max(f, g)
+ExactAdd exact_add_maximum(const Cudd& mgr, const ExactAdd& f, const ExactAdd& g);
+
+/**
+ * @brief Computes the ExactAdd of the value of a BDD forest, see bdd_forest_to_add
+ * @param mgr The cudd node manager to create the ADD in
+ * @param bdds The function to convert. Bit i has the significance 2^i
+ * @param table The table for the values
+ * @param num_rep The number representation of bdds
+ * @return The given function as an ExactAdd
+ */
+ExactAdd bdd_forest_to_exact_add(const Cudd& mgr, const std::vector<BDD>& bdds,
+                                 std::shared_ptr<ExactValueTable> table,
+                                 const NumberRepresentation num_rep =
+                                     NumberRepresentation::BaseTwo);
+
+/**
+ * @brief Finds all values of the ExactAdd and how often each of them occurs, see
+ * add_terminal_values
+ * @param add The function to compute the values of
+ * @return For every value, the value and the exact number of assignments of all variables of the
+ * manager for which the function evaluates to it
+ */
+std::vector<std::pair<boost::multiprecision::cpp_rational, boost::multiprecision::cpp_int>>
+exact_add_terminal_values(const ExactAdd& add);
+
+} // namespace abo::util
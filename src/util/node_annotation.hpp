@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <cudd/cudd/cudd.h>
+
+namespace abo::util {
+
+/**
+ * @brief Stores one value per BDD node in a flat open-addressing hash table
+ *
+ * This is a replacement for std::map<DdNode*, T> when annotating the nodes of a BDD with some
+ * value, e.g. the minterm count. Keys and values are stored in two contiguous arrays and collisions
+ * are resolved by linear probing, so a lookup touches only a few neighbouring cache lines and never
+ * allocates. Complemented and regular edges to the same node are different keys, just as they are
+ * for the map.
+ *
+ * @tparam T The type of the stored values. Must be default constructible and must not be bool, as
+ * std::vector<bool> can not hand out references to its elements
+ */
+template <typename T>
+class NodeAnnotation
+{
+public:
+    /**
+     * @brief Creates an empty annotation table
+     * @param expected_size The number of nodes that are expected to be stored. The table is sized
+     * such that this many nodes can be inserted without rehashing
+     */
+    explicit NodeAnnotation(std::size_t expected_size = 0)
+    {
+        std::size_t capacity = 16;
+        while (capacity < 2 * expected_size)
+        {
+            capacity *= 2;
+        }
+        resize(capacity);
+    }
+
+    //! Returns the value stored for node. A default constructed value is inserted if necessary
+    T& operator[](DdNode* node)
+    {
+        std::size_t slot = find_slot(node);
+        if (keys[slot] == nullptr)
+        {
+            if (2 * (stored + 1) > keys.size())
+            {
+                resize(2 * keys.size());
+                slot = find_slot(node);
+            }
+            keys[slot] = node;
+            stored++;
+        }
+        return values[slot];
+    }
+
+    //! Returns a pointer to the value stored for node or nullptr if node is not annotated
+    const T* find(DdNode* node) const
+    {
+        std::size_t slot = find_slot(node);
+        return keys[slot] == nullptr ? nullptr : &values[slot];
+    }
+
+    //! Returns a pointer to the value stored for node or nullptr if node is not annotated
+    T* find(DdNode* node)
+    {
+        std::size_t slot = find_slot(node);
+        return keys[slot] == nullptr ? nullptr : &values[slot];
+    }
+
+    //! Returns the value stored for node. Throws std::out_of_range if node is not annotated
+    const T& at(DdNode* node) const
+    {
+        const T* value = find(node);
+        if (value == nullptr)
+        {
+            throw std::out_of_range("NodeAnnotation::at: node is not annotated");
+        }
+        return *value;
+    }
+
+    //! Returns whether a value is stored for node
+    bool contains(DdNode* node) const
+    {
+        return keys[find_slot(node)] != nullptr;
+    }
+
+    //! Returns the number of annotated nodes
+    std::size_t size() const
+    {
+        return stored;
+    }
+
+    //! Calls fun(node, value) for every annotated node. The order is unspecified
+    template <typename Function>
+    void for_each(Function fun) const
+    {
+        for (std::size_t i = 0; i < keys.size(); i++)
+        {
+            if (keys[i] != nullptr)
+            {
+                fun(keys[i], values[i]);
+            }
+        }
+    }
+
+private:
+    //! Returns the slot containing node or the empty slot where it would have to be inserted
+    std::size_t find_slot(DdNode* node) const
+    {
+        // fibonacci hashing, the lowest bits of a node address are always zero
+        std::uint64_t hash = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(node));
+        std::size_t slot = static_cast<std::size_t>((hash * 0x9E3779B97F4A7C15ULL) >> shift);
+        const std::size_t mask = keys.size() - 1;
+        while (keys[slot] != nullptr && keys[slot] != node)
+        {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    void resize(std::size_t capacity)
+    {
+        std::vector<DdNode*> old_keys = std::move(keys);
+        std::vector<T> old_values = std::move(values);
+        keys.assign(capacity, nullptr);
+        values = std::vector<T>(capacity);
+
+        shift = 64;
+        for (std::size_t c = capacity; c > 1; c /= 2)
+        {
+            shift--;
+        }
+
+        for (std::size_t i = 0; i < old_keys.size(); i++)
+        {
+            if (old_keys[i] != nullptr)
+            {
+                std::size_t slot = find_slot(old_keys[i]);
+                keys[slot] = old_keys[i];
+                values[slot] = std::move(old_values[i]);
+            }
+        }
+    }
+
+    //! nullptr marks an empty slot (CUDD never hands out a null node)
+    std::vector<DdNode*> keys;
+    std::vector<T> values;
+    std::size_t stored = 0;
+    //! 64 - log2(keys.size()), used to select the top bits of the hash
+    unsigned int shift = 64;
+};
+
+} // namespace abo::util
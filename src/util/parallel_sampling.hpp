@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace abo::util {
+
+/**
+ * @brief The number of samples that form one unit of work of a parallel sampling computation
+ *
+ * Each chunk draws its samples from its own random number stream, so the result of a computation
+ * only depends on the seed and the number of samples, but not on how the chunks are distributed
+ * among the threads.
+ */
+constexpr std::size_t samples_per_chunk = 1 << 14;
+
+//! Returns the number of chunks needed for the given number of samples
+inline std::size_t sample_chunk_count(std::size_t samples)
+{
+    return (samples + samples_per_chunk - 1) / samples_per_chunk;
+}
+
+//! Returns the number of samples in the given chunk
+inline std::size_t samples_in_chunk(std::size_t samples, std::size_t chunk)
+{
+    return std::min(samples_per_chunk, samples - chunk * samples_per_chunk);
+}
+
+/**
+ * @brief Resolves the number of threads to use
+ * @param threads The requested number of threads, zero selects the number of hardware threads
+ * @return The number of worker threads, at least one
+ */
+inline unsigned int resolve_thread_count(unsigned int threads)
+{
+    if (threads == 0)
+    {
+        threads = std::thread::hardware_concurrency();
+    }
+    return std::max(threads, 1u);
+}
+
+/**
+ * @brief Processes the chunks [0, num_chunks) on a pool of threads
+ *
+ * Every thread creates its own worker with make_worker (e.g. holding the scratch memory of an
+ * evaluator) and then repeatedly calls it with the next unprocessed chunk. The workers must not
+ * access a Cudd manager, as those are not thread safe; shared data like a CompiledForest must only
+ * be read. If a worker throws, the remaining chunks are skipped and the first exception is rethrown
+ * in the calling thread.
+ *
+ * @param num_chunks The number of chunks to process
+ * @param threads The number of threads to use, zero selects the number of hardware threads
+ * @param make_worker Called once per thread, returns a callable taking the chunk index
+ */
+template <typename WorkerFactory>
+void parallel_chunks(std::size_t num_chunks, unsigned int threads, WorkerFactory make_worker)
+{
+    const unsigned int num_threads =
+        static_cast<unsigned int>(std::min<std::size_t>(resolve_thread_count(threads), num_chunks));
+
+    std::atomic<std::size_t> next_chunk{0};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto run = [&]() {
+        try
+        {
+            auto worker = make_worker();
+            for (std::size_t chunk = next_chunk++; chunk < num_chunks; chunk = next_chunk++)
+            {
+                worker(chunk);
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+            next_chunk = num_chunks;
+        }
+    };
+
+    if (num_threads <= 1)
+    {
+        run();
+    }
+    else
+    {
+        std::vector<std::thread> pool;
+        pool.reserve(num_threads - 1);
+        for (unsigned int i = 1; i < num_threads; i++)
+        {
+            pool.emplace_back(run);
+        }
+        // the calling thread works as well
+        run();
+        for (std::thread& thread : pool)
+        {
+            thread.join();
+        }
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace abo::util
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace abo::util {
+
+/**
+ * @brief The xoshiro256** pseudo random number generator by Blackman and Vigna
+ *
+ * It is much faster than std::mt19937_64 and has a small state, so every thread or every chunk of
+ * samples can use its own generator. It satisfies the UniformRandomBitGenerator requirements and
+ * can be used with the distributions of the standard library.
+ */
+class Xoshiro256StarStar
+{
+public:
+    using result_type = std::uint64_t;
+
+    /**
+     * @brief Creates a generator for the given seed and stream
+     *
+     * The state is derived from seed and stream with splitmix64, so the same pair always yields the
+     * same sequence and different streams of the same seed are statistically independent. This
+     * allows to assign a fixed stream to every unit of work, which makes the results independent
+     * of the order in which the work is processed.
+     *
+     * @param seed The seed
+     * @param stream The number of the stream within the seed
+     */
+    explicit Xoshiro256StarStar(std::uint64_t seed = 0, std::uint64_t stream = 0)
+    {
+        // mix the stream into the seed before it is expanded, so that neighbouring seeds and
+        // streams do not produce overlapping states
+        std::uint64_t splitmix_state = seed ^ splitmix64(stream);
+        for (std::uint64_t& s : state)
+        {
+            s = splitmix64(splitmix_state);
+        }
+    }
+
+    static constexpr result_type min()
+    {
+        return 0;
+    }
+
+    static constexpr result_type max()
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator()()
+    {
+        const std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const std::uint64_t t = state[1] << 17;
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+
+        return result;
+    }
+
+    //! Returns a uniformly distributed random number with 53 significant bits in [0, 2^53)
+    std::uint64_t next_53_bits()
+    {
+        return (*this)() >> 11;
+    }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    //! Advances the given splitmix64 state and returns the next output
+    static std::uint64_t splitmix64(std::uint64_t& x)
+    {
+        std::uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    std::uint64_t state[4];
+};
+
+} // namespace abo::util
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cmath>
+
+namespace abo::util {
+
+/**
+ * @brief Accumulates count, mean and the sum of squared deviations of a sequence of samples
+ *
+ * The mean and variance are updated with Welford's method, which is numerically stable even for
+ * many samples of large values. Moments of disjoint sets of samples can be merged, e.g. to combine
+ * the results of several threads.
+ */
+struct RunningMoments
+{
+    long count = 0;
+    double mean = 0;
+    //! The sum of squared deviations from the mean
+    double m2 = 0;
+
+    //! Adds a single sample
+    void add(double value)
+    {
+        count++;
+        const double delta = value - mean;
+        mean += delta / count;
+        m2 += delta * (value - mean);
+    }
+
+    //! Adds the samples described by other (Chan et al.)
+    void merge(const RunningMoments& other)
+    {
+        if (other.count == 0)
+        {
+            return;
+        }
+        const long total = count + other.count;
+        const double delta = other.mean - mean;
+        mean += delta * other.count / total;
+        m2 += other.m2 + delta * delta * count * other.count / total;
+        count = total;
+    }
+
+    //! Returns the unbiased sample variance
+    double variance() const
+    {
+        return count > 1 ? m2 / (count - 1) : 0;
+    }
+};
+
+/**
+ * @brief Returns the deviation of the two-sided empirical Bernstein bound (Audibert et al.)
+ *
+ * With probability at least 1 - delta, the expected value of samples in [0, range] lies within
+ * moments.mean +- the returned deviation.
+ */
+inline double empirical_bernstein_deviation(const RunningMoments& moments, double range,
+                                            double delta)
+{
+    const double n = static_cast<double>(moments.count);
+    const double log_term = std::log(3 / delta);
+    return std::sqrt(2 * moments.variance() * log_term / n) + 3 * range * log_term / n;
+}
+
+} // namespace abo::util
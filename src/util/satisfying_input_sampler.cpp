@@ -0,0 +1,86 @@
+#include "satisfying_input_sampler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace abo::util {
+
+SamplingThresholds::SamplingThresholds(const CompiledForest& forest)
+    : SamplingThresholds(forest, forest.minterm_fractions())
+{
+}
+
+SamplingThresholds::SamplingThresholds(const CompiledForest& forest,
+                                       const std::vector<double>& fractions)
+    : compiled(&forest)
+{
+    satisfiable.reserve(forest.num_outputs());
+    for (std::size_t output = 0; output < forest.num_outputs(); output++)
+    {
+        satisfiable.push_back(CompiledForest::edge_fraction(fractions, forest.root(output)) > 0);
+    }
+
+    then_threshold.resize(2 * forest.num_nodes(), 0);
+    for (std::size_t n = 1; n < forest.num_nodes(); n++)
+    {
+        const double then_fraction = CompiledForest::edge_fraction(fractions, forest.then_edge(n));
+        const double else_fraction = CompiledForest::edge_fraction(fractions, forest.else_edge(n));
+        for (int parity = 0; parity < 2; parity++)
+        {
+            // a complemented path to the node swaps the satisfying and unsatisfying inputs
+            const double t = parity == 0 ? then_fraction : 1.0 - then_fraction;
+            const double e = parity == 0 ? else_fraction : 1.0 - else_fraction;
+            // nodes without satisfying inputs are never visited
+            const double probability = t + e > 0 ? t / (t + e) : 0.5;
+            // a probability of one is mapped to 2^53, which is larger than every drawn number
+            then_threshold[2 * n + parity] =
+                static_cast<std::uint64_t>(std::ldexp(probability, 53));
+        }
+    }
+}
+
+SatisfyingInputSampler::SatisfyingInputSampler(const CompiledForest& forest, std::size_t output)
+    : own_thresholds(std::make_shared<const SamplingThresholds>(forest)),
+      thresholds(own_thresholds.get()), output(output), root(forest.root(output))
+{
+}
+
+SatisfyingInputSampler::SatisfyingInputSampler(const SamplingThresholds& thresholds,
+                                               std::size_t output)
+    : thresholds(&thresholds), output(output), root(thresholds.forest().root(output))
+{
+}
+
+void SatisfyingInputSampler::sample(Xoshiro256StarStar& generator, std::size_t count,
+                                    std::size_t num_variables,
+                                    BitParallelEvaluator::Word* inputs) const
+{
+    constexpr std::size_t block_size = BitParallelEvaluator::block_size;
+    const std::size_t block_words = num_variables * BitParallelEvaluator::words_per_block;
+    const CompiledForest& forest = thresholds->forest();
+
+    for (std::size_t block_start = 0; block_start < count; block_start += block_size)
+    {
+        BitParallelEvaluator::Word* block = inputs + (block_start / block_size) * block_words;
+        std::generate(block, block + block_words, std::ref(generator));
+
+        const std::size_t block_samples = std::min(block_size, count - block_start);
+        for (std::size_t lane = 0; lane < block_samples; lane++)
+        {
+            CompiledForest::Edge edge = root;
+            unsigned int parity = CompiledForest::is_complemented(edge) ? 1 : 0;
+            while (!CompiledForest::is_constant(edge))
+            {
+                const std::size_t node = CompiledForest::edge_node(edge);
+                const bool take_then =
+                    generator.next_53_bits() < thresholds->threshold(node, parity);
+                set_block_bit(block, forest.variable(node), lane, take_then);
+                edge = take_then ? forest.then_edge(node) : forest.else_edge(node);
+                parity ^= CompiledForest::is_complemented(edge) ? 1 : 0;
+            }
+        }
+    }
+}
+
+} // namespace abo::util
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "bit_parallel_evaluation.hpp"
+#include "compiled_forest.hpp"
+#include "random.hpp"
+
+namespace abo::util {
+
+/**
+ * @brief The branching probabilities of all nodes of a compiled forest for drawing uniformly
+ * distributed satisfying inputs
+ *
+ * For every node, the probability to take the then branch is computed once from the minterm
+ * fractions of its children. It does not depend on the output that is sampled, so one instance is
+ * shared by the samplers of all outputs of the forest.
+ */
+class SamplingThresholds
+{
+public:
+    /**
+     * @brief Computes the thresholds of all nodes
+     * @param forest The compiled functions. Must outlive the thresholds
+     */
+    explicit SamplingThresholds(const CompiledForest& forest);
+
+    /**
+     * @brief Computes the thresholds of all nodes, reusing already computed minterm fractions
+     * @param forest The compiled functions. Must outlive the thresholds
+     * @param fractions The result of forest.minterm_fractions()
+     */
+    SamplingThresholds(const CompiledForest& forest, const std::vector<double>& fractions);
+
+    //! Returns the compiled functions
+    const CompiledForest& forest() const
+    {
+        return *compiled;
+    }
+
+    //! Returns whether the given output has any satisfying input at all
+    bool is_satisfiable(std::size_t output) const
+    {
+        return satisfiable[output];
+    }
+
+    //! Returns the threshold of the node, see then_threshold
+    std::uint64_t threshold(std::size_t node, unsigned int parity) const
+    {
+        return then_threshold[2 * node + parity];
+    }
+
+private:
+    const CompiledForest* compiled;
+    std::vector<bool> satisfiable;
+    //! The probability to take the then branch for every node, scaled to 2^53. Entry 2 * n is used
+    //! when node n is reached with an even number of complemented edges, entry 2 * n + 1 otherwise
+    std::vector<std::uint64_t> then_threshold;
+};
+
+/**
+ * @brief Draws uniformly distributed satisfying inputs of one output of a compiled forest
+ *
+ * A sample is a single walk from the root to the constant node, taking the branches with the
+ * probabilities of the SamplingThresholds, while all variables skipped by the walk are set
+ * uniformly at random.
+ *
+ * The samples are written bit-sliced in blocks, in the same layout as the inputs of the
+ * BitParallelEvaluator, so that they can be evaluated without conversion. The sampler is never
+ * modified after construction and can be used from several threads, each with its own generator.
+ */
+class SatisfyingInputSampler
+{
+public:
+    /**
+     * @brief Prepares the sampling of the given output with thresholds of its own
+     * @param forest The compiled functions. Must outlive the sampler
+     * @param output The output whose satisfying inputs are drawn
+     */
+    SatisfyingInputSampler(const CompiledForest& forest, std::size_t output);
+
+    /**
+     * @brief Prepares the sampling of the given output with shared thresholds
+     * @param thresholds The thresholds of the forest of the output. Must outlive the sampler
+     * @param output The output whose satisfying inputs are drawn
+     */
+    SatisfyingInputSampler(const SamplingThresholds& thresholds, std::size_t output);
+
+    //! Returns whether the output has any satisfying input at all
+    bool is_satisfiable() const
+    {
+        return thresholds->is_satisfiable(output);
+    }
+
+    /**
+     * @brief Draws count satisfying inputs
+     * @param generator The random number generator to use
+     * @param count The number of samples to draw
+     * @param num_variables The number of variables in each block, must be at least
+     * forest.num_inputs(). Variables not in the support of the output are set randomly
+     * @param inputs The samples are written here. Must have space for
+     * ceil(count / BitParallelEvaluator::block_size) blocks of
+     * num_variables * BitParallelEvaluator::words_per_block words each. The bits of unused samples
+     * in the last block are random
+     */
+    void sample(Xoshiro256StarStar& generator, std::size_t count, std::size_t num_variables,
+                BitParallelEvaluator::Word* inputs) const;
+
+private:
+    //! Only set if the sampler was constructed without shared thresholds
+    std::shared_ptr<const SamplingThresholds> own_thresholds;
+    const SamplingThresholds* thresholds;
+    std::size_t output;
+    CompiledForest::Edge root;
+};
+
+} // namespace abo::util
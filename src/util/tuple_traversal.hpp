@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "compiled_forest.hpp"
+
+namespace abo::util {
+
+//! Hashes a tuple of edges of a compiled forest
+struct EdgeTupleHash
+{
+    std::size_t operator()(const std::vector<CompiledForest::Edge>& tuple) const
+    {
+        std::size_t hash = tuple.size();
+        for (CompiledForest::Edge edge : tuple)
+        {
+            hash ^= edge + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+        }
+        return hash;
+    }
+};
+
+/**
+ * @brief Reduces several outputs of a compiled forest jointly over all inputs
+ *
+ * The outputs are traversed together, one variable level at a time. A state of the traversal is the
+ * tuple of edges that the outputs have reached after a prefix of the variable order is fixed, i.e.
+ * their joint cofactor. Every distinct tuple is reduced only once, so the cost is proportional to
+ * the number of distinct joint cofactors. This is the size of the multi-terminal diagram of the
+ * vector-valued function, but the diagram itself is never built.
+ *
+ * Levels on which none of the outputs depend are skipped, so combine(r, r) must equal r for
+ * every result r. Averages and maxima have this property.
+ *
+ * @param forest The compiled functions
+ * @param outputs The indices of the outputs to reduce together
+ * @param max_states The number of distinct tuples after which the traversal gives up. The number
+ * of joint cofactors can be exponential in the size of the forest, e.g. for the bits of a sum, so
+ * callers with a cheaper fallback bound it
+ * @param leaf Called as leaf(values) once all outputs are constant, values[i] being the value of
+ * outputs[i]
+ * @param combine Called as combine(then_result, else_result) for every state that branches on a
+ * variable
+ * @return The result for the tuple of the roots, or nothing if more than max_states tuples were
+ * reached
+ */
+template <typename Leaf, typename Combine>
+auto reduce_output_tuples(const CompiledForest& forest, const std::vector<std::size_t>& outputs,
+                          std::size_t max_states, Leaf leaf, Combine combine)
+    -> std::optional<decltype(leaf(std::vector<bool>()))>
+{
+    using Edge = CompiledForest::Edge;
+    using Result = decltype(leaf(std::vector<bool>()));
+
+    //! Unwinds the traversal once the limit is reached
+    struct LimitReached
+    {
+    };
+
+    std::unordered_map<std::vector<Edge>, Result, EdgeTupleHash> results;
+
+    // the nodes are numbered by level with the deepest level first, so the node with the highest
+    // number is on the topmost level of the tuple and all nodes of that level share its variable
+    auto reduce = [&](const std::vector<Edge>& tuple, auto& self) -> Result {
+        auto it = results.find(tuple);
+        if (it != results.end())
+        {
+            return it->second;
+        }
+        if (results.size() >= max_states)
+        {
+            throw LimitReached();
+        }
+
+        std::size_t top = 0;
+        for (Edge edge : tuple)
+        {
+            top = std::max(top, CompiledForest::edge_node(edge));
+        }
+
+        if (top == 0)
+        {
+            std::vector<bool> values(tuple.size());
+            for (std::size_t i = 0; i < tuple.size(); i++)
+            {
+                values[i] = !CompiledForest::is_complemented(tuple[i]);
+            }
+            return results.emplace(tuple, leaf(values)).first->second;
+        }
+
+        const unsigned int variable = forest.variable(top);
+        std::vector<Edge> then_tuple = tuple;
+        std::vector<Edge> else_tuple = tuple;
+        for (std::size_t i = 0; i < tuple.size(); i++)
+        {
+            const std::size_t node = CompiledForest::edge_node(tuple[i]);
+            if (node != 0 && forest.variable(node) == variable)
+            {
+                const Edge complement = tuple[i] & 1;
+                then_tuple[i] = forest.then_edge(node) ^ complement;
+                else_tuple[i] = forest.else_edge(node) ^ complement;
+            }
+        }
+        Result then_result = self(then_tuple, self);
+        Result else_result = self(else_tuple, self);
+        return results.emplace(tuple, combine(then_result, else_result)).first->second;
+    };
+
+    std::vector<Edge> roots;
+    roots.reserve(outputs.size());
+    for (std::size_t output : outputs)
+    {
+        roots.push_back(forest.root(output));
+    }
+    try
+    {
+        return reduce(roots, reduce);
+    }
+    catch (const LimitReached&)
+    {
+        return std::nullopt;
+    }
+}
+
+//! Computes reduce_output_tuples without a limit on the number of tuples
+template <typename Leaf, typename Combine>
+auto reduce_output_tuples(const CompiledForest& forest, const std::vector<std::size_t>& outputs,
+                          Leaf leaf, Combine combine)
+{
+    return *reduce_output_tuples(forest, outputs, std::numeric_limits<std::size_t>::max(), leaf,
+                                 combine);
+}
+
+} // namespace abo::util
@@ -13,6 +13,18 @@
 #include <worst_case_error.hpp>
 #include <average_case_error.hpp>
 #include <worst_case_relative_error.hpp>
+#include <sequential_sampling.hpp>
+#include <importance_sampling.hpp>
+#include <metric_context.hpp>
+#include <incremental_metrics.hpp>
+#include <compute_metrics.hpp>
+#include <average_bit_flip_error.hpp>
+#include <worst_case_bit_flip_error.hpp>
+#include <average_case_relative_error.hpp>
+#include <guarded_evaluation.hpp>
+#include <batch_evaluation.hpp>
+#include <value_distribution.hpp>
+#include <bucket_minimization.hpp>
 
 #include <iostream>
 
@@ -210,3 +222,603 @@ TEST_CASE("Simple worst case relative error metrics") {
     check_wcr_values(mgr, abo::util::number_to_bdds(mgr, 3),
                      abo::util::number_to_bdds(mgr, 18), 5);
 }
+
+TEST_CASE("ADD based metrics on functions with many inputs") {
+    const int n = 100;
+    Cudd mgr(n);
+
+    // the approximation differs from the original only if the first and the last variable are set
+    BDD first = mgr.bddVar(0);
+    BDD last = mgr.bddVar(n - 1);
+    std::vector<BDD> f({first, mgr.bddZero()});
+    std::vector<BDD> f_hat({first * !last, first * last});
+
+    CHECK(abo::error_metrics::error_rate_add(mgr, f, f_hat) == Approx(0.25));
+    CHECK(abo::error_metrics::average_case_error_add(mgr, f, f_hat) == 0.25);
+}
+
+TEST_CASE("Sampled error rate does not depend on the number of threads") {
+    Cudd mgr(8);
+
+    std::vector<BDD> f;
+    std::vector<BDD> f_hat;
+    for (int i = 0; i < 4; i++) {
+        f.push_back(mgr.bddVar(i) ^ mgr.bddVar(i + 4));
+        f_hat.push_back(i < 2 ? f.back() : mgr.bddVar(i));
+    }
+
+    const long samples = 100000;
+    double exact = abo::error_metrics::error_rate(mgr, f, f_hat);
+    double single = abo::error_metrics::error_rate_sampling(mgr, f, f_hat, samples, 7, 1);
+    double parallel = abo::error_metrics::error_rate_sampling(mgr, f, f_hat, samples, 7, 4);
+    CHECK(single == parallel);
+    CHECK(single == Approx(exact).margin(0.01));
+
+    double efficient_single =
+        abo::error_metrics::error_rate_efficient_sampling(mgr, f, f_hat, samples, 7, 1);
+    double efficient_parallel =
+        abo::error_metrics::error_rate_efficient_sampling(mgr, f, f_hat, samples, 7, 4);
+    CHECK(efficient_single == efficient_parallel);
+    CHECK(efficient_single == Approx(exact).margin(0.01));
+}
+
+TEST_CASE("Sequential sampling intervals contain the exact values") {
+    Cudd mgr(6);
+
+    // f is the number given by the first three variables, f_hat drops its lowest bit and adds the
+    // fourth variable as an error in the highest bit
+    std::vector<BDD> f({mgr.bddVar(0), mgr.bddVar(1), mgr.bddVar(2), mgr.bddZero()});
+    std::vector<BDD> f_hat({mgr.bddZero(), mgr.bddVar(1), mgr.bddVar(2), mgr.bddVar(3)});
+
+    double exact_er = abo::error_metrics::error_rate(mgr, f, f_hat);
+    auto er = abo::error_metrics::error_rate_sequential_sampling(mgr, f, f_hat, 0.99, 0.01);
+    CHECK(er.lower_bound <= exact_er);
+    CHECK(exact_er <= er.upper_bound);
+    CHECK(er.upper_bound - er.lower_bound <= 0.02);
+    CHECK(er.samples > 0);
+
+    double exact_ace = static_cast<double>(abo::error_metrics::average_case_error(mgr, f, f_hat));
+    auto ace = abo::error_metrics::average_case_error_sequential_sampling(mgr, f, f_hat, 0.99, 0.1,
+                                                                          1L << 24, 9);
+    CHECK(ace.lower_bound <= exact_ace);
+    CHECK(exact_ace <= ace.upper_bound);
+    CHECK(ace.estimate == Approx(exact_ace).margin(0.1));
+
+    // an interval from no samples at all would be meaningless
+    CHECK_THROWS_AS(
+        abo::error_metrics::error_rate_sequential_sampling(mgr, f, f_hat, 0.99, 0.01, 0),
+        std::invalid_argument);
+    CHECK_THROWS_AS(abo::error_metrics::mean_squared_error_sequential_sampling(mgr, f, f_hat, 0.99,
+                                                                               0.1, -1),
+                    std::invalid_argument);
+}
+
+TEST_CASE("Importance sampling of the miter") {
+    Cudd mgr(6);
+
+    // errors occur only for one in 32 inputs and only in the highest bit, so every weighted
+    // sample is exactly the same and the estimate is exact
+    BDD rare = mgr.bddVar(2) * mgr.bddVar(3) * mgr.bddVar(4) * mgr.bddVar(5) * mgr.bddVar(1);
+    std::vector<BDD> f({mgr.bddVar(0), mgr.bddVar(1), mgr.bddVar(2), mgr.bddZero()});
+    std::vector<BDD> f_hat({mgr.bddVar(0), mgr.bddVar(1), mgr.bddVar(2), rare});
+
+    double exact_ace = static_cast<double>(abo::error_metrics::average_case_error(mgr, f, f_hat));
+    auto ace = abo::error_metrics::average_case_error_importance_sampling(mgr, f, f_hat, 100000);
+    CHECK(ace.lower_bound <= exact_ace);
+    CHECK(exact_ace <= ace.upper_bound);
+    CHECK(ace.estimate == Approx(exact_ace));
+    CHECK(ace.variance < 1e-12);
+
+    double exact_mse = static_cast<double>(abo::error_metrics::mean_squared_error(mgr, f, f_hat));
+    auto mse = abo::error_metrics::mean_squared_error_importance_sampling(
+        mgr, f, f_hat, 100000, 0.99, abo::util::NumberRepresentation::BaseTwo, 3, 4);
+    CHECK(mse.lower_bound <= exact_mse);
+    CHECK(exact_mse <= mse.upper_bound);
+    CHECK(mse.estimate == Approx(exact_mse));
+
+    std::vector<BDD> same = f;
+    CHECK(abo::error_metrics::average_case_error_importance_sampling(mgr, f, same).estimate == 0);
+    CHECK_THROWS_AS(abo::error_metrics::average_case_error_importance_sampling(mgr, f, f_hat, 0),
+                    std::invalid_argument);
+}
+
+TEST_CASE("Metrics computed from a shared context") {
+    Cudd mgr(6);
+
+    std::vector<BDD> f(
+        {mgr.bddVar(0), mgr.bddVar(1), mgr.bddVar(2), mgr.bddVar(3) * mgr.bddVar(4)});
+    std::vector<BDD> f_hat({mgr.bddZero(), mgr.bddVar(1), mgr.bddVar(2) | mgr.bddVar(5),
+                            mgr.bddVar(3)});
+
+    abo::error_metrics::MetricContext context(mgr, f, f_hat);
+    CHECK(&context.absolute_difference() == &context.absolute_difference());
+
+    CHECK(abo::error_metrics::worst_case_error(context) ==
+          abo::error_metrics::worst_case_error(mgr, f, f_hat));
+    CHECK(abo::error_metrics::average_case_error(context) ==
+          abo::error_metrics::average_case_error(mgr, f, f_hat));
+    CHECK(abo::error_metrics::mean_squared_error(context) ==
+          abo::error_metrics::mean_squared_error(mgr, f, f_hat));
+    CHECK(abo::error_metrics::error_rate(context) == abo::error_metrics::error_rate(mgr, f, f_hat));
+    CHECK(abo::error_metrics::wcre_add(context) == abo::error_metrics::wcre_add(mgr, f, f_hat));
+    CHECK(abo::error_metrics::acre_add(context) == abo::error_metrics::acre_add(mgr, f, f_hat));
+    CHECK(abo::error_metrics::wcre_bounds(context) ==
+          abo::error_metrics::wcre_bounds(mgr, f, f_hat));
+}
+
+TEST_CASE("Prepared original shared between approximations") {
+    Cudd mgr(6);
+
+    std::vector<BDD> f({mgr.bddVar(0), mgr.bddVar(1), mgr.bddVar(2), mgr.bddVar(3)});
+    std::vector<std::vector<BDD>> candidates{
+        {mgr.bddZero(), mgr.bddVar(1), mgr.bddVar(2), mgr.bddVar(3)},
+        {mgr.bddVar(0), mgr.bddVar(1) | mgr.bddVar(4), mgr.bddVar(2), mgr.bddVar(5)}};
+
+    auto original = std::make_shared<abo::error_metrics::PreparedOriginal>(
+        mgr, f, abo::util::NumberRepresentation::TwosComplement);
+    for (const auto& f_hat : candidates) {
+        abo::error_metrics::MetricContext context(original, f_hat);
+        CHECK(&context.original_absolute() == &original->absolute());
+        CHECK(abo::error_metrics::wcre_add(context) ==
+              abo::error_metrics::wcre_add(mgr, f, f_hat,
+                                           abo::util::NumberRepresentation::TwosComplement));
+        CHECK(abo::error_metrics::acre_add(context) ==
+              abo::error_metrics::acre_add(mgr, f, f_hat,
+                                           abo::util::NumberRepresentation::TwosComplement));
+        CHECK(abo::error_metrics::worst_case_error_add(context) ==
+              abo::error_metrics::worst_case_error(
+                  mgr, f, f_hat, abo::util::NumberRepresentation::TwosComplement));
+    }
+}
+
+TEST_CASE("Incremental bit-wise metrics for single output changes") {
+    Cudd mgr(6);
+
+    std::vector<BDD> f;
+    std::vector<BDD> f_hat;
+    for (int i = 0; i < 5; i++) {
+        f.push_back(mgr.bddVar(i) ^ mgr.bddVar(i + 1));
+        f_hat.push_back(i % 2 == 0 ? mgr.bddVar(i) : f.back());
+    }
+
+    abo::error_metrics::IncrementalMetrics incremental(mgr, f, f_hat);
+    CHECK(incremental.error_rate() == Approx(abo::error_metrics::error_rate(mgr, f, f_hat)));
+    CHECK(incremental.average_bit_flip_error() ==
+          Approx(abo::error_metrics::average_bit_flip_error(f, f_hat)));
+    CHECK(incremental.worst_case_bit_flip_error() ==
+          abo::error_metrics::worst_case_bit_flip_error(mgr, f, f_hat));
+
+    for (std::size_t output = 0; output < f.size(); output++) {
+        for (const BDD& replacement : {mgr.bddZero(), f[output], mgr.bddVar(5)}) {
+            std::vector<BDD> candidate = f_hat;
+            candidate[output] = replacement;
+            CHECK(incremental.error_rate(output, replacement) ==
+                  Approx(abo::error_metrics::error_rate(mgr, f, candidate)));
+            CHECK(incremental.average_bit_flip_error(output, replacement) ==
+                  Approx(abo::error_metrics::average_bit_flip_error(f, candidate)));
+            CHECK(incremental.worst_case_bit_flip_error(output, replacement) ==
+                  abo::error_metrics::worst_case_bit_flip_error(mgr, f, candidate));
+        }
+    }
+
+    // with 60 inputs, an error on a single input is below the precision of a double next to 1
+    Cudd wide(60);
+    BDD any = wide.bddZero();
+    for (int i = 0; i < 60; i++)
+    {
+        any |= wide.bddVar(i);
+    }
+    std::vector<BDD> g({any, wide.bddVar(0)});
+    std::vector<BDD> g_hat({wide.bddOne(), wide.bddVar(0)});
+    abo::error_metrics::IncrementalMetrics wide_incremental(wide, g, g_hat);
+    CHECK(wide_incremental.error_rate() == std::ldexp(1.0, -60));
+    CHECK(wide_incremental.error_rate() == abo::error_metrics::error_rate(wide, g, g_hat));
+    CHECK(wide_incremental.average_bit_flip_error() ==
+          abo::error_metrics::average_bit_flip_error(g, g_hat));
+    for (const BDD& replacement : {wide.bddVar(1), wide.bddVar(0) | !any})
+    {
+        std::vector<BDD> candidate = g_hat;
+        candidate[1] = replacement;
+        CHECK(wide_incremental.error_rate(1, replacement) ==
+              abo::error_metrics::error_rate(wide, g, candidate));
+        CHECK(wide_incremental.average_bit_flip_error(1, replacement) ==
+              abo::error_metrics::average_bit_flip_error(g, candidate));
+    }
+}
+
+TEST_CASE("Fused computation of several metrics") {
+    Cudd mgr(6);
+
+    std::vector<BDD> f({mgr.bddVar(0) ^ mgr.bddVar(3), mgr.bddVar(1) & mgr.bddVar(4),
+                        mgr.bddVar(2) | mgr.bddVar(5), mgr.bddVar(3)});
+    std::vector<BDD> f_hat({mgr.bddVar(0), mgr.bddVar(1), mgr.bddVar(2) | mgr.bddVar(5),
+                            mgr.bddVar(4)});
+
+    auto values = abo::error_metrics::compute_metrics(mgr, f, f_hat);
+    CHECK(values.error_rate == Approx(abo::error_metrics::error_rate(mgr, f, f_hat)));
+    CHECK(values.average_bit_flip_error ==
+          Approx(abo::error_metrics::average_bit_flip_error(f, f_hat)));
+    CHECK(values.worst_case_bit_flip_error ==
+          abo::error_metrics::worst_case_bit_flip_error(mgr, f, f_hat));
+    CHECK(values.average_case_error ==
+          Approx(static_cast<double>(abo::error_metrics::average_case_error(mgr, f, f_hat))));
+    CHECK(values.mean_squared_error ==
+          Approx(static_cast<double>(abo::error_metrics::mean_squared_error(mgr, f, f_hat))));
+
+    abo::error_metrics::MetricSet only_mse;
+    only_mse.mean_squared_error = true;
+    auto mse = abo::error_metrics::compute_metrics(mgr, f, f_hat, only_mse);
+    CHECK(mse.mean_squared_error == values.mean_squared_error);
+    CHECK(mse.error_rate == 0);
+
+    // only the input 0 differs, its fraction 2^-60 vanishes next to 1 in double precision
+    Cudd wide(60);
+    BDD any = wide.bddZero();
+    for (int i = 0; i < 60; i++)
+    {
+        any |= wide.bddVar(i);
+    }
+    std::vector<BDD> g({any, wide.bddZero()});
+    std::vector<BDD> g_hat({wide.bddOne(), wide.bddZero()});
+    auto wide_values = abo::error_metrics::compute_metrics(wide, g, g_hat);
+    CHECK(wide_values.error_rate == std::ldexp(1.0, -60));
+    CHECK(wide_values.error_rate == abo::error_metrics::error_rate(wide, g, g_hat));
+    CHECK(wide_values.average_bit_flip_error ==
+          abo::error_metrics::average_bit_flip_error(g, g_hat));
+    CHECK(wide_values.average_case_error == std::ldexp(1.0, -60));
+}
+
+TEST_CASE("Moments of the signed error") {
+    Cudd mgr(4);
+
+    std::vector<BDD> f({mgr.bddVar(0) ^ mgr.bddVar(2), mgr.bddVar(1) | mgr.bddVar(3),
+                        mgr.bddVar(2) & mgr.bddVar(3)});
+    std::vector<BDD> f_hat({mgr.bddVar(0), mgr.bddVar(1), mgr.bddVar(3)});
+
+    // enumerate the signed differences explicitly
+    double sum = 0;
+    double square_sum = 0;
+    for (int x = 0; x < 16; x++)
+    {
+        std::vector<int> input{x & 1, (x >> 1) & 1, (x >> 2) & 1, (x >> 3) & 1};
+        double difference = 0;
+        for (std::size_t i = 0; i < f.size(); i++)
+        {
+            difference += (f[i].Eval(input.data()).IsOne() - f_hat[i].Eval(input.data()).IsOne()) *
+                          static_cast<double>(1 << i);
+        }
+        sum += difference;
+        square_sum += difference * difference;
+    }
+    const double bias = sum / 16;
+    const double mse = square_sum / 16;
+
+    CHECK(abo::error_metrics::error_bias(mgr, f, f_hat) == Approx(bias));
+    CHECK(abo::error_metrics::error_variance(mgr, f, f_hat) == Approx(mse - bias * bias));
+    CHECK(static_cast<double>(abo::error_metrics::mean_squared_error(mgr, f, f_hat)) ==
+          Approx(mse));
+    CHECK(static_cast<double>(abo::error_metrics::mean_squared_error(mgr, f, f_hat)) ==
+          Approx(static_cast<double>(abo::error_metrics::mean_squared_error_add(mgr, f, f_hat))));
+
+    std::vector<BDD> minus_one({mgr.bddOne(), mgr.bddOne()});
+    auto moments = abo::error_metrics::value_moments(
+        minus_one, abo::util::NumberRepresentation::TwosComplement);
+    CHECK(moments.mean == -1);
+    CHECK(moments.variance == 0);
+
+    // the sum of two numbers, whose squared value couples all bits
+    std::vector<BDD> a({mgr.bddVar(0), mgr.bddVar(1)});
+    std::vector<BDD> b({mgr.bddVar(2), mgr.bddVar(3)});
+    const std::vector<BDD> a_plus_b = abo::util::bdd_add(mgr, a, b);
+    double sum_squares = 0;
+    for (int x = 0; x < 16; x++)
+    {
+        const int value = (x & 3) + (x >> 2);
+        sum_squares += value * value;
+    }
+    CHECK(static_cast<double>(abo::error_metrics::mean_squared_value(a_plus_b)) ==
+          Approx(sum_squares / 16));
+    CHECK(abo::error_metrics::value_moments(a_plus_b).mean_square() == Approx(sum_squares / 16));
+
+    // the moments are exact integers, so a large offset does not swamp the variance
+    std::vector<BDD> offset(60, mgr.bddZero());
+    offset[0] = mgr.bddVar(0);
+    offset[59] = mgr.bddOne();
+    auto offset_moments = abo::error_metrics::value_moments(offset);
+    CHECK(offset_moments.mean == Approx(std::ldexp(1.0, 59)));
+    CHECK(offset_moments.variance == 0.25);
+}
+
+TEST_CASE("Witnesses of the worst case errors") {
+    Cudd mgr(4);
+
+    std::vector<BDD> f({mgr.bddVar(0) ^ mgr.bddVar(2), mgr.bddVar(1) | mgr.bddVar(3),
+                        mgr.bddVar(2) & mgr.bddVar(3)});
+    std::vector<BDD> f_hat({mgr.bddVar(0), mgr.bddVar(1), mgr.bddVar(3)});
+
+    auto difference = abo::util::bdd_absolute_difference(mgr, f, f_hat,
+                                                         abo::util::NumberRepresentation::BaseTwo);
+
+    auto witness = abo::error_metrics::worst_case_error_witness(mgr, f, f_hat);
+    CHECK(witness.value == abo::error_metrics::worst_case_error(mgr, f, f_hat));
+    CHECK(abo::util::eval(difference, witness.input) == witness.value);
+
+    auto errors = abo::error_metrics::worst_case_errors(mgr, f, f_hat, 100);
+    REQUIRE(!errors.empty());
+    CHECK(errors.front().value == witness.value);
+    CHECK(errors.back().value == 0);
+    for (std::size_t i = 0; i < errors.size(); i++)
+    {
+        CHECK(abo::util::eval(difference, errors[i].input) == errors[i].value);
+        if (i > 0)
+        {
+            CHECK(errors[i].value < errors[i - 1].value);
+        }
+    }
+    CHECK(abo::error_metrics::worst_case_errors(mgr, f, f_hat, 1).size() == 1);
+
+    auto flips = abo::error_metrics::worst_case_bit_flip_error_witness(mgr, f, f_hat);
+    CHECK(flips.value == abo::error_metrics::worst_case_bit_flip_error(mgr, f, f_hat));
+    unsigned int flipped = 0;
+    for (std::size_t i = 0; i < f.size(); i++)
+    {
+        flipped += f[i].Eval(flips.input.data()) != f_hat[i].Eval(flips.input.data());
+    }
+    CHECK(flipped == flips.value);
+}
+
+TEST_CASE("Anytime bounds on the worst case errors") {
+    Cudd mgr(8);
+
+    std::vector<BDD> f;
+    std::vector<BDD> f_hat;
+    for (int i = 0; i < 6; i++)
+    {
+        f.push_back(mgr.bddVar(i) ^ mgr.bddVar(i + 2));
+        f_hat.push_back(i < 3 ? mgr.bddVar(i) : f[i]);
+    }
+    f_hat[5] = mgr.bddVar(7);
+
+    const auto wce = abo::error_metrics::worst_case_error(mgr, f, f_hat);
+    auto exact = abo::error_metrics::worst_case_error_anytime(mgr, f, f_hat, {});
+    CHECK(exact.first == wce);
+    CHECK(exact.second == wce);
+
+    abo::util::ComputationBudget no_time;
+    no_time.time = std::chrono::steady_clock::duration::zero();
+    auto rough = abo::error_metrics::worst_case_error_anytime(mgr, f, f_hat, no_time);
+    CHECK(rough.first <= wce);
+    CHECK(rough.second >= wce);
+
+    const double wcre = abo::error_metrics::wcre_add(mgr, f, f_hat);
+    auto relative = abo::error_metrics::wcre_anytime(mgr, f, f_hat, {});
+    CHECK(relative.first <= wcre + 0.001);
+    CHECK(relative.second >= wcre - 0.001);
+    auto rough_relative = abo::error_metrics::wcre_anytime(mgr, f, f_hat, no_time);
+    CHECK(rough_relative.first <= relative.first);
+    CHECK(rough_relative.second >= relative.second);
+
+    // the node limit aborts the steps themselves, which keeps the bounds of the previous step
+    abo::util::ComputationBudget no_nodes;
+    no_nodes.live_nodes = 1;
+    auto aborted = abo::error_metrics::worst_case_error_anytime(mgr, f, f_hat, no_nodes);
+    CHECK(aborted.first <= wce);
+    CHECK(aborted.second >= wce);
+    auto aborted_relative = abo::error_metrics::wcre_anytime(mgr, f, f_hat, no_nodes);
+    CHECK(aborted_relative.first <= wcre + 0.001);
+    CHECK(aborted_relative.second >= wcre - 0.001);
+    CHECK(abo::error_metrics::worst_case_error(mgr, f, f_hat) == wce);
+
+    // only the sign bit differs, so every input has the error 2^5
+    std::vector<BDD> g;
+    for (int i = 0; i < 6; i++)
+    {
+        g.push_back(mgr.bddVar(i));
+    }
+    std::vector<BDD> g_hat = g;
+    g_hat[5] = !g[5];
+    const auto twos = abo::util::NumberRepresentation::TwosComplement;
+    CHECK(abo::error_metrics::worst_case_error(mgr, g, g_hat, twos) == 32);
+    auto sign = abo::error_metrics::worst_case_error_anytime(mgr, g, g_hat, {}, twos);
+    CHECK(sign.first == 32);
+    CHECK(sign.second == 32);
+    auto rough_sign = abo::error_metrics::worst_case_error_anytime(mgr, g, g_hat, no_time, twos);
+    CHECK(rough_sign.first <= 32);
+    CHECK(rough_sign.second >= 32);
+    CHECK(abo::error_metrics::approximate_worst_case_error(mgr, g, g_hat, 1, twos) >= 32);
+}
+
+TEST_CASE("Guarded evaluation falls back to sampling") {
+    Cudd mgr(8);
+
+    std::vector<BDD> f;
+    std::vector<BDD> f_hat;
+    for (int i = 0; i < 4; i++)
+    {
+        f.push_back(mgr.bddVar(i) ^ mgr.bddVar(i + 4));
+        f_hat.push_back(mgr.bddVar(i) | mgr.bddVar(i + 4));
+    }
+
+    const double ace = static_cast<double>(abo::error_metrics::average_case_error(mgr, f, f_hat));
+    auto exact = abo::error_metrics::guarded_average_case_error(mgr, f, f_hat, {}, 0.99, 0.1);
+    CHECK(exact.exact);
+    CHECK(exact.value == Approx(ace));
+    CHECK(exact.samples == 0);
+
+    abo::util::ComputationBudget no_nodes;
+    no_nodes.live_nodes = 1;
+    auto estimate =
+        abo::error_metrics::guarded_average_case_error(mgr, f, f_hat, no_nodes, 0.99, 0.1);
+    CHECK_FALSE(estimate.exact);
+    CHECK(estimate.samples > 0);
+    CHECK(estimate.lower_bound <= ace);
+    CHECK(estimate.upper_bound >= ace);
+
+    // the manager is usable again after the aborted computation
+    CHECK(abo::error_metrics::error_rate(mgr, f, f_hat) == Approx(0.68359375));
+    auto rate = abo::error_metrics::guarded_error_rate(mgr, f, f_hat, {});
+    CHECK(rate.exact);
+    CHECK(rate.value == Approx(0.68359375));
+}
+
+TEST_CASE("Batch evaluation of candidates with selector variables") {
+    Cudd mgr(8);
+
+    std::vector<BDD> f;
+    for (int i = 0; i < 4; i++)
+    {
+        f.push_back(mgr.bddVar(i) ^ mgr.bddVar(i + 4));
+    }
+    std::vector<std::vector<BDD>> candidates(3, f);
+    candidates[0][0] = mgr.bddZero();
+    candidates[1][3] = mgr.bddVar(3);
+    candidates[2][1] = mgr.bddVar(1) | mgr.bddVar(5);
+    candidates[2][2] = mgr.bddOne();
+
+    using abo::error_metrics::MetricContext;
+    auto ace = abo::error_metrics::evaluate_candidates(mgr, f, candidates, [](MetricContext& c) {
+        return static_cast<double>(abo::error_metrics::average_case_error(c));
+    });
+    auto wce = abo::error_metrics::evaluate_candidates(mgr, f, candidates, [](MetricContext& c) {
+        return static_cast<double>(abo::error_metrics::worst_case_error(c));
+    });
+    auto er = abo::error_metrics::evaluate_candidates(mgr, f, candidates, [](MetricContext& c) {
+        return abo::error_metrics::error_rate(c);
+    });
+    REQUIRE(ace.size() == 3);
+    for (std::size_t j = 0; j < 3; j++)
+    {
+        CHECK(ace[j] ==
+              Approx(static_cast<double>(
+                  abo::error_metrics::average_case_error(mgr, f, candidates[j]))));
+        CHECK(wce[j] == static_cast<double>(
+                            abo::error_metrics::worst_case_error(mgr, f, candidates[j])));
+        CHECK(er[j] == Approx(abo::error_metrics::error_rate(mgr, f, candidates[j])));
+    }
+
+    // the selector variables are reused by later batches
+    CHECK(mgr.ReadSize() == 10);
+
+    // unused variables anywhere in the order are used before the manager grows
+    Cudd sparse(5);
+    std::vector<BDD> g({sparse.bddVar(0) & sparse.bddVar(3), sparse.bddVar(1) | sparse.bddVar(4)});
+    std::vector<std::vector<BDD>> g_candidates({{sparse.bddVar(0), g[1]}, {g[0], sparse.bddOne()}});
+    auto rate = [](MetricContext& c) { return abo::error_metrics::error_rate(c); };
+    auto g_er = abo::error_metrics::evaluate_candidates(sparse, g, g_candidates, rate);
+    CHECK(sparse.ReadSize() == 5);
+    for (std::size_t j = 0; j < 2; j++)
+    {
+        CHECK(g_er[j] == Approx(abo::error_metrics::error_rate(sparse, g, g_candidates[j])));
+    }
+}
+
+TEST_CASE("Exact distribution of the error values") {
+    Cudd mgr(8);
+
+    std::vector<BDD> f;
+    std::vector<BDD> f_hat;
+    for (int i = 0; i < 4; i++)
+    {
+        f.push_back(mgr.bddVar(i) ^ mgr.bddVar(i + 4));
+        f_hat.push_back(mgr.bddVar(i) | mgr.bddVar(i + 4));
+    }
+
+    // the error is the sum of 2^i over the bits where both variables are one
+    const auto distribution = abo::error_metrics::error_distribution(mgr, f, f_hat);
+    CHECK(distribution.counts().size() == 16);
+    CHECK(distribution.total() == 256);
+    CHECK(distribution.count(0) == 81);
+    CHECK(distribution.count(15) == 1);
+    CHECK(distribution.count(16) == 0);
+    CHECK(distribution.maximum() == abo::error_metrics::worst_case_error(mgr, f, f_hat));
+    CHECK(static_cast<double>(distribution.mean()) ==
+          Approx(static_cast<double>(abo::error_metrics::average_case_error(mgr, f, f_hat))));
+    CHECK(static_cast<double>(distribution.mean_square()) ==
+          Approx(static_cast<double>(abo::error_metrics::mean_squared_error(mgr, f, f_hat))));
+    CHECK(distribution.nonzero_rate() == Approx(abo::error_metrics::error_rate(mgr, f, f_hat)));
+
+    CHECK(distribution.percentile(0) == 0);
+    CHECK(distribution.percentile(81.0 / 256) == 0);
+    CHECK(distribution.percentile(82.0 / 256) == 1);
+    CHECK(distribution.percentile(1) == 15);
+    const auto histogram = distribution.histogram(8);
+    REQUIRE(histogram.size() == 2);
+    CHECK(histogram[0] + histogram[1] == 256);
+    CHECK(histogram[1] == 64);
+}
+
+TEST_CASE("Lower bounds of the minimization metrics") {
+    Cudd mgr(4);
+
+    // f = 8 * x0 (i.e. 1000 or 0000), the approximations differ in various bits
+    std::vector<BDD> f(4, mgr.bddZero());
+    f[3] = mgr.bddVar(0);
+
+    std::vector<std::vector<BDD>> approximations;
+    // 0111 where f is 1000, only differing from the high bit in the carry
+    approximations.push_back({mgr.bddVar(0), mgr.bddVar(0), mgr.bddVar(0), mgr.bddZero()});
+    // only the high bit differs
+    approximations.push_back({mgr.bddZero(), mgr.bddZero(), mgr.bddZero(), mgr.bddZero()});
+    approximations.push_back({mgr.bddVar(1), mgr.bddVar(2), mgr.bddZero(), mgr.bddVar(3)});
+    approximations.push_back({mgr.bddZero(), mgr.bddVar(1) & mgr.bddVar(2), mgr.bddZero(), f[3]});
+    approximations.push_back(f);
+
+    for (const auto metric : {abo::minimization::ErrorMetric::WORST_CASE,
+                              abo::minimization::ErrorMetric::WORST_CASE_PERCENT,
+                              abo::minimization::ErrorMetric::ERROR_RATE})
+    {
+        const auto lower_bound = abo::minimization::metric_lower_bound(metric);
+        const auto exact = abo::minimization::metric_function(metric);
+        REQUIRE(lower_bound);
+        for (const auto& f_hat : approximations)
+        {
+            abo::error_metrics::MetricContext context(mgr, f, f_hat);
+            CHECK(lower_bound(context) <= exact(context));
+        }
+    }
+
+    // when only the high bit differs, the bound of the worst case error is tight
+    abo::error_metrics::MetricContext high_bit(mgr, f, approximations[1]);
+    CHECK(abo::minimization::metric_lower_bound(abo::minimization::ErrorMetric::WORST_CASE)(
+              high_bit) == 8);
+}
+
+TEST_CASE("ADD based metrics with more than 53 output bits") {
+    Cudd mgr(2);
+
+    // f = (2^60 - 1) * x0 and f_hat = (2^60 - 2) * x0 round to the same double
+    std::vector<BDD> f(60, mgr.bddVar(0));
+    std::vector<BDD> f_hat = f;
+    f_hat[0] = mgr.bddZero();
+
+    CHECK(abo::error_metrics::worst_case_error_add(mgr, f, f_hat) == 1);
+    CHECK(abo::error_metrics::worst_case_error(mgr, f, f_hat) == 1);
+    CHECK(static_cast<double>(abo::error_metrics::average_case_error_add(mgr, f, f_hat)) ==
+          Approx(0.5));
+    CHECK(static_cast<double>(abo::error_metrics::mean_squared_error_add(mgr, f, f_hat)) ==
+          Approx(0.5));
+    CHECK(abo::error_metrics::wcre_add(mgr, f, f_hat) == Approx(std::ldexp(1.0, -60)));
+
+    auto table = std::make_shared<abo::util::ExactValueTable>();
+    const auto exact = abo::util::bdd_forest_to_exact_add(mgr, f, table);
+    const auto values = abo::util::exact_add_terminal_values(exact);
+    REQUIRE(values.size() == 2);
+    for (const auto& [value, count] : values)
+    {
+        CHECK(count == 2);
+        CHECK((value == 0 || value == (boost::multiprecision::cpp_int(1) << 60) - 1));
+    }
+
+    // the values of every candidate are kept in the table of its context, not in the shared one
+    auto original = std::make_shared<abo::error_metrics::PreparedOriginal>(
+        mgr, f, abo::util::NumberRepresentation::BaseTwo);
+    for (int shift = 0; shift < 4; shift++)
+    {
+        std::vector<BDD> candidate = f;
+        candidate[shift] = mgr.bddVar(1);
+        abo::error_metrics::MetricContext context(original, candidate);
+        CHECK(abo::error_metrics::worst_case_error_add(context) == (1u << shift));
+        CHECK(abo::error_metrics::wcre_add(context) > 0);
+    }
+    CHECK(original->exact_table()->size() <= 3);
+}
@@ -1,8 +1,16 @@
+#include <accumulator.hpp>
+#include <allocation_counter.hpp>
+#include <bit_parallel_evaluation.hpp>
 #include <catch2/catch.hpp>
+#include <compiled_forest.hpp>
+#include <satisfying_input_sampler.hpp>
+#include <tuple_traversal.hpp>
+#include <worst_case_error.hpp>
 #include <cudd/cplusplus/cuddObj.hh>
 #include <cudd_helpers.hpp>
 #include <from_papers.hpp>
 #include <iostream>
+#include <set>
 
 
 TEST_CASE("Test child operators") {
@@ -206,3 +214,413 @@ TEST_CASE("Difference in Cofactor and Constrain(?)") {
 
 }
 
+
+TEST_CASE("Minterm and solution counts")
+{
+    Cudd mgr(3);
+
+    BDD x = mgr.bddVar(0);
+    BDD y = mgr.bddVar(1);
+    BDD z = mgr.bddVar(2);
+
+    BDD f = (x * y) + !z;
+
+    auto minterms = abo::util::count_minterms(f);
+    CHECK(minterms.at(f.getNode()) == Approx(5.0 / 8.0));
+    CHECK(minterms.at(mgr.bddOne().getNode()) == Approx(1.0));
+    CHECK(minterms.at(mgr.bddZero().getNode()) == Approx(0.0));
+    CHECK(minterms.find(f.getNode()) != nullptr);
+
+    auto negated_minterms = abo::util::count_minterms(!f);
+    CHECK(negated_minterms.at((!f).getNode()) == Approx(3.0 / 8.0));
+
+    auto solutions = abo::util::count_solutions(f);
+    CHECK(solutions.at(f.getNode()) == Approx(5.0));
+}
+
+TEST_CASE("Bit-parallel evaluation matches BDD evaluation")
+{
+    Cudd mgr(4);
+
+    BDD a = mgr.bddVar(0);
+    BDD b = mgr.bddVar(1);
+    BDD c = mgr.bddVar(2);
+    BDD d = mgr.bddVar(3);
+
+    std::vector<BDD> forest = {a ^ b ^ c, (a * b) + (c * !d), !(b + d), mgr.bddOne(), mgr.bddZero()};
+
+    abo::util::CompiledForest compiled(forest);
+    abo::util::BitParallelEvaluator evaluator(compiled);
+    REQUIRE(evaluator.num_inputs() == 4);
+    REQUIRE(evaluator.num_outputs() == forest.size());
+
+    constexpr std::size_t words = abo::util::BitParallelEvaluator::words_per_block;
+    std::vector<abo::util::BitParallelEvaluator::Word> inputs(4 * words, 0);
+    std::vector<abo::util::BitParallelEvaluator::Word> outputs(forest.size() * words, 0);
+
+    // enumerate all 16 inputs, repeated over the whole block
+    for (std::size_t lane = 0; lane < abo::util::BitParallelEvaluator::block_size; lane++)
+    {
+        for (std::size_t v = 0; v < 4; v++)
+        {
+            abo::util::set_block_bit(inputs.data(), v, lane, ((lane >> v) & 1) != 0);
+        }
+    }
+    evaluator.evaluate(inputs.data(), outputs.data());
+
+    for (std::size_t lane = 0; lane < abo::util::BitParallelEvaluator::block_size; lane++)
+    {
+        std::vector<int> input = {int(lane & 1), int((lane >> 1) & 1), int((lane >> 2) & 1),
+                                  int((lane >> 3) & 1)};
+        for (std::size_t i = 0; i < forest.size(); i++)
+        {
+            CHECK(abo::util::get_block_bit(outputs.data(), i, lane) ==
+                  forest[i].Eval(input.data()).IsOne());
+        }
+    }
+}
+
+TEST_CASE("Compiled forest evaluation and minterm fractions")
+{
+    Cudd mgr(3);
+
+    BDD x = mgr.bddVar(0);
+    BDD y = mgr.bddVar(1);
+    BDD z = mgr.bddVar(2);
+
+    // 100 outputs, the highest one being set for the all-one input only
+    std::vector<BDD> forest(100, mgr.bddZero());
+    forest[0] = x ^ y;
+    forest[1] = !(y * z);
+    forest[99] = x * y * z;
+
+    abo::util::CompiledForest compiled(forest);
+    REQUIRE(compiled.num_outputs() == 100);
+    REQUIRE(compiled.num_inputs() == 3);
+
+    for (int input = 0; input < 8; input++)
+    {
+        std::vector<int> values = {input & 1, (input >> 1) & 1, (input >> 2) & 1};
+        CHECK(compiled.evaluate_number(values) == abo::util::eval(forest, values));
+    }
+    boost::multiprecision::cpp_int expected = 1;
+    expected <<= 99;
+    CHECK(compiled.evaluate_number({1, 1, 1}) == expected);
+    CHECK(compiled.evaluate_number({1, 0, 1}) == 3);
+
+    std::vector<double> fractions = compiled.minterm_fractions();
+    CHECK(abo::util::CompiledForest::edge_fraction(fractions, compiled.root(0)) == Approx(0.5));
+    CHECK(abo::util::CompiledForest::edge_fraction(fractions, compiled.root(1)) == Approx(0.75));
+    CHECK(abo::util::CompiledForest::edge_fraction(fractions, compiled.root(2)) == Approx(0.0));
+    CHECK(abo::util::CompiledForest::edge_fraction(fractions, compiled.root(99)) ==
+          Approx(0.125));
+}
+
+TEST_CASE("Exact minterm counts of a compiled forest")
+{
+    Cudd mgr(100);
+
+    BDD any = mgr.bddZero();
+    for (int i = 0; i < 100; i++)
+    {
+        any |= mgr.bddVar(i);
+    }
+    std::vector<BDD> forest({any, !any, mgr.bddVar(50) & mgr.bddVar(99), mgr.bddOne()});
+
+    // the counts exceed the precision of a double
+    abo::util::CompiledForest compiled(forest);
+    const boost::multiprecision::cpp_int all = boost::multiprecision::cpp_int(1) << 100;
+    std::vector<boost::multiprecision::cpp_int> counts = compiled.output_minterm_counts();
+    CHECK(counts[0] == all - 1);
+    CHECK(counts[1] == 1);
+    CHECK(counts[2] == all / 4);
+    CHECK(counts[3] == all);
+
+    std::vector<abo::util::UInt128> narrow_counts = compiled.minterm_counts<abo::util::UInt128>();
+    for (std::size_t i = 0; i < counts.size(); i++)
+    {
+        CHECK(abo::util::to_cpp_int(narrow_counts[i]) == counts[i]);
+    }
+
+    // a small manager uses the 64 bit path
+    Cudd small(3);
+    abo::util::CompiledForest small_compiled({small.bddVar(0) | small.bddVar(2)});
+    CHECK(small_compiled.output_minterm_counts().front() == 6);
+}
+
+TEST_CASE("Joint traversal of outputs with a limit on the tuples")
+{
+    Cudd mgr(6);
+
+    std::vector<BDD> a({mgr.bddVar(0), mgr.bddVar(2), mgr.bddVar(4)});
+    std::vector<BDD> b({mgr.bddVar(1), mgr.bddVar(3), mgr.bddVar(5)});
+    const std::vector<BDD> sum = abo::util::bdd_add(mgr, a, b);
+    abo::util::CompiledForest compiled(sum);
+    std::vector<std::size_t> outputs(sum.size());
+    for (std::size_t i = 0; i < outputs.size(); i++)
+    {
+        outputs[i] = i;
+    }
+
+    auto leaf = [](const std::vector<bool>& bits) {
+        unsigned int value = 0;
+        for (std::size_t i = 0; i < bits.size(); i++)
+        {
+            value |= static_cast<unsigned int>(bits[i]) << i;
+        }
+        return value;
+    };
+    auto maximum = [](unsigned int then_value, unsigned int else_value) {
+        return std::max(then_value, else_value);
+    };
+    CHECK(abo::util::reduce_output_tuples(compiled, outputs, leaf, maximum) == 14);
+    CHECK(abo::util::reduce_output_tuples(compiled, outputs, 1000, leaf, maximum) ==
+          std::optional<unsigned int>(14));
+    CHECK_FALSE(abo::util::reduce_output_tuples(compiled, outputs, 1, leaf, maximum));
+}
+
+TEST_CASE("Differences of functions that share low and high bits")
+{
+    Cudd mgr(4);
+
+    BDD x = mgr.bddVar(0);
+    BDD y = mgr.bddVar(1);
+    BDD z = mgr.bddVar(2);
+    BDD w = mgr.bddVar(3);
+
+    // only bits 1 and 2 differ
+    std::vector<BDD> f({x, y & z, z, w, x & w});
+    std::vector<BDD> g({x, y, z & w, w, x & w});
+
+    // interprets a forest as a number in Two's Complement
+    auto signed_value = [](const std::vector<BDD>& forest, const std::vector<int>& input) {
+        boost::multiprecision::cpp_int value = abo::util::eval(forest, input);
+        if (bit_test(value, static_cast<unsigned int>(forest.size() - 1)))
+        {
+            value -= boost::multiprecision::cpp_int(1) << forest.size();
+        }
+        return value;
+    };
+
+    for (auto num_rep : {abo::util::NumberRepresentation::BaseTwo,
+                         abo::util::NumberRepresentation::TwosComplement})
+    {
+        const bool is_signed = num_rep == abo::util::NumberRepresentation::TwosComplement;
+        auto absolute = abo::util::bdd_absolute_difference(mgr, f, g, num_rep);
+        auto difference = abo::util::bdd_difference(mgr, f, g, num_rep);
+        CHECK(absolute.size() == (is_signed ? f.size() : f.size() + 1));
+        CHECK(difference.size() == absolute.size());
+
+        for (int input = 0; input < 16; input++)
+        {
+            std::vector<int> values = {input & 1, (input >> 1) & 1, (input >> 2) & 1,
+                                       (input >> 3) & 1};
+            boost::multiprecision::cpp_int expected =
+                is_signed ? signed_value(f, values) - signed_value(g, values)
+                          : abo::util::eval(f, values) - abo::util::eval(g, values);
+            CHECK(signed_value(difference, values) == expected);
+            CHECK(abo::util::eval(absolute, values) == abs(expected));
+        }
+    }
+
+    auto same = abo::util::bdd_absolute_difference(mgr, f, f,
+                                                   abo::util::NumberRepresentation::BaseTwo);
+    CHECK(same.size() == f.size() + 1);
+    CHECK(abo::util::eval(same, {1, 1, 1, 1}) == 0);
+}
+
+TEST_CASE("Sampled satisfying inputs satisfy the function")
+{
+    Cudd mgr(4);
+
+    BDD a = mgr.bddVar(0);
+    BDD b = mgr.bddVar(1);
+    BDD c = mgr.bddVar(2);
+    BDD d = mgr.bddVar(3);
+
+    std::vector<BDD> forest = {!((a * b) + (c ^ d)), mgr.bddZero()};
+    abo::util::CompiledForest compiled(forest);
+    abo::util::BitParallelEvaluator evaluator(compiled);
+
+    // the samplers of all outputs share the thresholds of the forest
+    const abo::util::SamplingThresholds thresholds(compiled);
+    abo::util::SatisfyingInputSampler sampler(thresholds, 0);
+    REQUIRE(sampler.is_satisfiable());
+    REQUIRE_FALSE(abo::util::SatisfyingInputSampler(thresholds, 1).is_satisfiable());
+    REQUIRE_FALSE(abo::util::SatisfyingInputSampler(compiled, 1).is_satisfiable());
+
+    constexpr std::size_t samples = 2 * abo::util::BitParallelEvaluator::block_size;
+    constexpr std::size_t words = abo::util::BitParallelEvaluator::words_per_block;
+    std::vector<abo::util::BitParallelEvaluator::Word> inputs(2 * 4 * words);
+    std::vector<abo::util::BitParallelEvaluator::Word> outputs(2 * words);
+
+    abo::util::Xoshiro256StarStar generator(42);
+    sampler.sample(generator, samples, 4, inputs.data());
+
+    // every drawn input satisfies the function and all six satisfying inputs are found
+    std::set<int> drawn;
+    for (std::size_t block = 0; block < 2; block++)
+    {
+        evaluator.evaluate(inputs.data() + block * 4 * words, outputs.data());
+        for (std::size_t lane = 0; lane < abo::util::BitParallelEvaluator::block_size; lane++)
+        {
+            CHECK(abo::util::get_block_bit(outputs.data(), 0, lane));
+            int input = 0;
+            for (std::size_t v = 0; v < 4; v++)
+            {
+                input |= abo::util::get_block_bit(inputs.data() + block * 4 * words, v, lane) << v;
+            }
+            drawn.insert(input);
+        }
+    }
+    CHECK(drawn.size() == 6);
+
+    // the same seed gives the same samples
+    std::vector<abo::util::BitParallelEvaluator::Word> repeated(inputs.size());
+    abo::util::Xoshiro256StarStar same_generator(42);
+    sampler.sample(same_generator, samples, 4, repeated.data());
+    CHECK(repeated == inputs);
+}
+
+//! The maximum value of fun, building every intersection to test it for emptiness
+static boost::multiprecision::uint256_t conjunction_max_value(const Cudd& mgr,
+                                                              const std::vector<BDD>& fun)
+{
+    boost::multiprecision::uint256_t value = 0;
+    BDD sigma = mgr.bddOne();
+    for (int i = int(fun.size()) - 1; i >= 0; i--)
+    {
+        BDD mask = sigma & fun[i];
+        if (!mask.IsZero())
+        {
+            bit_set(value, static_cast<unsigned int>(i));
+            sigma = mask;
+        }
+    }
+    return value;
+}
+
+//! exists_greater_equals for forests of the same size, building every intersection to test it for
+//! emptiness
+static std::pair<bool, bool> conjunction_greater_equals(const Cudd& mgr, const std::vector<BDD>& f1,
+                                                        const std::vector<BDD>& f2)
+{
+    BDD zero_condition = mgr.bddOne();
+    BDD equal_condition = mgr.bddOne();
+    for (int i = int(f1.size()) - 1; i >= 0; i--)
+    {
+        zero_condition &= !f2[i];
+        if (!((f1[i] & zero_condition).IsZero()))
+        {
+            return {true, false};
+        }
+        if (!((f1[i] & !f2[i] & equal_condition).IsZero()))
+        {
+            return {true, false};
+        }
+        equal_condition &= (f1[i] & f2[i]) | ((!f1[i]) & (!f2[i]));
+    }
+    if (!equal_condition.IsZero())
+    {
+        return {true, true};
+    }
+    return {false, false};
+}
+
+TEST_CASE("Emptiness checks do not allocate nodes")
+{
+    struct Operands
+    {
+        std::vector<BDD> f;
+        std::vector<BDD> g;
+    };
+    // both forms run on a manager of their own with the same functions, so neither reuses the
+    // nodes of the other
+    auto operands = [](const Cudd& mgr, int which) {
+        const BDD x0 = mgr.bddVar(0);
+        const BDD x1 = mgr.bddVar(1);
+        const BDD x2 = mgr.bddVar(2);
+        const BDD x3 = mgr.bddVar(3);
+        switch (which)
+        {
+        case 0: // f > g for some inputs
+            return Operands{{x0 & x1, x2 | x3}, {x0, x2 & x3}};
+        case 1: // f == g for all inputs
+            return Operands{{x0, x2 & x3}, {x0, x2 & x3}};
+        default: // f < g for all inputs
+            return Operands{{mgr.bddZero(), mgr.bddZero()}, {x0, mgr.bddOne()}};
+        }
+    };
+    const std::vector<std::pair<bool, bool>> expected = {
+        {true, false}, {true, true}, {false, false}};
+    const std::vector<boost::multiprecision::uint256_t> maxima = {3, 3, 0};
+
+    long leq_nodes = 0;
+    long conjunction_nodes = 0;
+    for (int which = 0; which < 3; which++)
+    {
+        Cudd leq_mgr(4);
+        const Operands leq_operands = operands(leq_mgr, which);
+        abo::util::AllocationCounter leq_counter(leq_mgr);
+        CHECK(abo::util::exists_greater_equals(leq_mgr, leq_operands.f, leq_operands.g) ==
+              expected[which]);
+        CHECK(abo::error_metrics::get_max_value(leq_mgr, leq_operands.f) == maxima[which]);
+        REQUIRE(leq_counter.is_exact());
+
+        Cudd conjunction_mgr(4);
+        const Operands conjunction_operands = operands(conjunction_mgr, which);
+        abo::util::AllocationCounter conjunction_counter(conjunction_mgr);
+        CHECK(conjunction_greater_equals(conjunction_mgr, conjunction_operands.f,
+                                         conjunction_operands.g) == expected[which]);
+        CHECK(conjunction_max_value(conjunction_mgr, conjunction_operands.f) == maxima[which]);
+        REQUIRE(conjunction_counter.is_exact());
+
+        CHECK(leq_counter.allocated_nodes() <= conjunction_counter.allocated_nodes());
+        leq_nodes += leq_counter.allocated_nodes();
+        conjunction_nodes += conjunction_counter.allocated_nodes();
+    }
+    // f > g is found from an intersection that is not empty, which only the old form builds
+    CHECK(leq_nodes < conjunction_nodes);
+}
+
+TEST_CASE("Value ADDs built directly from BDD forests")
+{
+    Cudd mgr(4);
+
+    BDD x = mgr.bddVar(0);
+    BDD y = mgr.bddVar(1);
+    BDD z = mgr.bddVar(2);
+    BDD w = mgr.bddVar(3);
+
+    std::vector<BDD> f({x ^ y, y & z, z | w, x & w});
+    std::vector<BDD> g({x, y, z & w, !w});
+
+    for (auto num_rep : {abo::util::NumberRepresentation::BaseTwo,
+                         abo::util::NumberRepresentation::TwosComplement})
+    {
+        // the reference is built with Horner's scheme, ADDs are canonical
+        auto horner = [&](const std::vector<BDD>& forest) {
+            ADD result = mgr.addZero();
+            ADD two = mgr.addOne() + mgr.addOne();
+            for (std::size_t i = forest.size(); i-- > 0;)
+            {
+                result = result * two + forest[i].Add();
+            }
+            if (num_rep == abo::util::NumberRepresentation::TwosComplement)
+            {
+                ADD sign_weight = mgr.constant(std::ldexp(1.0, static_cast<int>(forest.size())));
+                result -= forest.back().Add() * sign_weight;
+            }
+            return result;
+        };
+
+        const ADD f_add = abo::util::bdd_forest_to_add(mgr, f, num_rep);
+        const ADD g_add = abo::util::bdd_forest_to_add(mgr, g, num_rep);
+        CHECK(f_add == horner(f));
+        CHECK(g_add == horner(g));
+        CHECK(abo::util::absolute_difference_add(mgr, f, g, num_rep) ==
+              abo::util::absolute_difference_add(mgr, f_add, g_add));
+    }
+
+    CHECK(abo::util::bdd_forest_to_add(mgr, {}) == mgr.addZero());
+}